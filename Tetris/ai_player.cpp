@@ -0,0 +1,151 @@
+// ai_player.cpp
+
+#include "ai_player.h"  // Includes the AIPlayer class
+#include "board.h"      // Includes the Board class which represents the game grid
+#include "piece.h"      // Includes the Piece class which represents the Tetris pieces
+
+// Checks if a shape fits at (x, y) on an occupancy grid
+static bool fits(const std::vector<std::vector<int>>& shape, const std::vector<char>& cells, int width, int height, int x, int y) {
+    for (int i = 0; i < static_cast<int>(shape.size()); ++i) {
+        for (int j = 0; j < static_cast<int>(shape[i].size()); ++j) {
+            if (shape[i][j] == 1) {
+                int cx = x + i;
+                int cy = y + j;
+                if (cx < 0 || cx >= width || cy < 0 || cy >= height || cells[cy * width + cx]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Constructor: nothing is planned until the first call to nextAction()
+AIPlayer::AIPlayer(Game* g) : game(g), plannedPiece(-1), rotationsLeft(0), targetX(0), lastX(0), movedSideways(false) {
+}
+
+bool AIPlayer::nextAction(InputAction& action) {
+    if (game->isGameOver()) {
+        return false;
+    }
+
+    // Plan once per piece
+    if (game->getPiecesSpawned() != plannedPiece) {
+        plan();
+    }
+
+    int x = game->getPiece()->getPieceX();
+
+    // A horizontal move that did not change the column means the way is blocked: stop steering
+    if (movedSideways && x == lastX) {
+        targetX = x;
+    }
+    movedSideways = false;
+
+    if (rotationsLeft > 0) {
+        rotationsLeft--;
+        action = InputAction::Rotate;
+    } else if (x != targetX) {
+        lastX = x;
+        movedSideways = true;
+        action = x < targetX ? InputAction::MoveRight : InputAction::MoveLeft;
+    } else {
+        action = InputAction::MoveDown;  // In place: soft drop until the piece lands
+    }
+    return true;
+}
+
+void AIPlayer::plan() {
+    Board* board = game->getBoard();
+    Piece* piece = game->getPiece();
+    int width = board->getWidth();
+    int height = board->getHeight();
+
+    plannedPiece = game->getPiecesSpawned();
+    rotationsLeft = 0;
+    targetX = piece->getPieceX();
+    movedSideways = false;
+
+    // Take a copy of the board occupancy
+    base.assign(width * height, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            base[y * width + x] = board->isCellEmpty(x, y) ? 0 : 1;
+        }
+    }
+
+    // Try every rotation and column, dropping the piece straight down from its current row
+    std::vector<std::vector<int>> shape = piece->getShape();
+    double bestScore = -1e30;
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        for (int x = 0; x + static_cast<int>(shape.size()) <= width; ++x) {
+            int y = piece->getPieceY();
+            if (!fits(shape, base, width, height, x, y)) {
+                continue;
+            }
+            while (fits(shape, base, width, height, x, y + 1)) {
+                y++;
+            }
+
+            // Place the piece on a copy of the board and score the result
+            scratch = base;
+            for (int i = 0; i < static_cast<int>(shape.size()); ++i) {
+                for (int j = 0; j < static_cast<int>(shape[i].size()); ++j) {
+                    if (shape[i][j] == 1) {
+                        scratch[(y + j) * width + x + i] = 1;
+                    }
+                }
+            }
+            double score = evaluate(scratch, width, height);
+            if (score > bestScore) {
+                bestScore = score;
+                rotationsLeft = rotation;
+                targetX = x;
+            }
+        }
+        shape = Piece::rotatedShape(shape);
+    }
+}
+
+double AIPlayer::evaluate(const std::vector<char>& cells, int width, int height) {
+    // Find the full rows: they will be cleared, so they do not count towards height or holes
+    int lines = 0;
+    full.assign(height, 0);  // Keeps its capacity, so only the first evaluation allocates
+    for (int y = 0; y < height; ++y) {
+        bool isFull = true;
+        for (int x = 0; x < width && isFull; ++x) {
+            isFull = cells[y * width + x] != 0;
+        }
+        full[y] = isFull;
+        lines += isFull;
+    }
+
+    // Column heights and holes (empty cells below the top of a column)
+    int aggregateHeight = 0, holes = 0, bumpiness = 0, previousHeight = -1;
+    for (int x = 0; x < width; ++x) {
+        int columnHeight = 0;
+        int rowsBelow = height - lines;  // Rows left once the full ones are gone
+        bool seenTop = false;
+        for (int y = 0; y < height; ++y) {
+            if (full[y]) {
+                continue;
+            }
+            if (cells[y * width + x]) {
+                if (!seenTop) {
+                    columnHeight = rowsBelow;
+                    seenTop = true;
+                }
+            } else if (seenTop) {
+                holes++;
+            }
+            rowsBelow--;
+        }
+        aggregateHeight += columnHeight;
+        if (previousHeight >= 0) {
+            bumpiness += columnHeight > previousHeight ? columnHeight - previousHeight : previousHeight - columnHeight;
+        }
+        previousHeight = columnHeight;
+    }
+
+    return 0.76 * lines - 0.51 * aggregateHeight - 0.36 * holes - 0.18 * bumpiness;
+}
@@ -0,0 +1,38 @@
+// ai_player.h
+
+#ifndef AI_PLAYER_H
+#define AI_PLAYER_H
+
+#include <vector>   // Include vector for the scratch occupancy grid
+
+#include "game.h"   // Includes the Game class and the InputAction enum
+
+// AIPlayer drives a Game without a keyboard: for every new piece it tries each rotation and column,
+// keeps the placement with the best board evaluation, then steers the piece there one action at a time
+class AIPlayer {
+public:
+    // Constructor: attaches the AI to the game it plays
+    explicit AIPlayer(Game* g);
+
+    // Gives the next action to send to the game; returns false when the game is over
+    bool nextAction(InputAction& action);
+
+private:
+    // Chooses the target rotation and column for the current piece
+    void plan();
+
+    // Scores a board occupancy grid (higher is better): rewards cleared lines, penalizes height, holes and bumpiness
+    double evaluate(const std::vector<char>& cells, int width, int height);
+
+    Game* game;                 // The game being played
+    int plannedPiece;           // Spawn number of the piece the current plan was made for
+    int rotationsLeft;          // Rotations still to perform
+    int targetX;                // Column the piece is steered to
+    int lastX;                  // Piece column before the last horizontal move (to detect a blocked piece)
+    bool movedSideways;         // True if the last action was a horizontal move
+    std::vector<char> base;     // Occupancy of the board when planning
+    std::vector<char> scratch;  // Occupancy grid reused for every candidate placement
+    std::vector<char> full;     // Full-row flags reused by every evaluation
+};
+
+#endif
@@ -0,0 +1,258 @@
+// alloc_tracker.cpp
+
+#include "alloc_tracker.h"  // Includes the AllocTracker class
+
+#include <atomic>   // Include atomic for counters updated from every thread
+#include <cstdlib>  // Include for malloc and free
+#include <new>      // Include for the operator new signatures and std::bad_alloc
+#ifdef _WIN32
+#include <malloc.h> // Include for _aligned_malloc and _aligned_free
+#endif
+
+static const int SUBSYSTEMS = static_cast<int>(AllocSubsystem::Count);
+
+// Counters shared by every thread (relaxed: they are only read for reports)
+static std::atomic<Uint64> allocationCount[SUBSYSTEMS];
+static std::atomic<Uint64> allocationBytes[SUBSYSTEMS];
+static std::atomic<Uint64> freeCount;
+
+// Subsystem of the innermost AllocScope on each thread
+static thread_local AllocSubsystem currentSubsystem = AllocSubsystem::Other;
+
+bool AllocTracker::enabled() {
+#ifdef TETRIS_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+
+void AllocTracker::record(size_t bytes) {
+    int index = static_cast<int>(currentSubsystem);
+    allocationCount[index].fetch_add(1, std::memory_order_relaxed);
+    allocationBytes[index].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocTracker::recordFree() {
+    freeCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+AllocSubsystem AllocTracker::current() {
+    return currentSubsystem;
+}
+
+void AllocTracker::setCurrent(AllocSubsystem subsystem) {
+    currentSubsystem = subsystem;
+}
+
+void AllocTracker::snapshot(AllocCounters& counters) {
+    for (int i = 0; i < SUBSYSTEMS; ++i) {
+        counters.allocations[i] = allocationCount[i].load(std::memory_order_relaxed);
+        counters.bytes[i] = allocationBytes[i].load(std::memory_order_relaxed);
+    }
+    counters.frees = freeCount.load(std::memory_order_relaxed);
+}
+
+const char* AllocTracker::name(AllocSubsystem subsystem) {
+    switch (subsystem) {
+        case AllocSubsystem::Other: return "other";
+        case AllocSubsystem::Simulation: return "simulation";
+        case AllocSubsystem::Render: return "render";
+        case AllocSubsystem::Text: return "text";
+        case AllocSubsystem::Audio: return "audio";
+        case AllocSubsystem::Capture: return "capture";
+        case AllocSubsystem::Solver: return "solver";
+        default: return "?";
+    }
+}
+
+Uint64 AllocTracker::allocationsBetween(const AllocCounters& before, const AllocCounters& after) {
+    Uint64 total = 0;
+    for (int i = 0; i < SUBSYSTEMS; ++i) {
+        total += after.allocations[i] - before.allocations[i];
+    }
+    return total;
+}
+
+void AllocTracker::logPerFrame(const AllocCounters& before, const AllocCounters& after, Uint64 frames) {
+    if (frames == 0) {
+        return;
+    }
+    for (int i = 0; i < SUBSYSTEMS; ++i) {
+        Uint64 count = after.allocations[i] - before.allocations[i];
+        if (count > 0) {
+            SDL_Log("Allocations (%s): %.2f per frame, %.0f bytes per frame",
+                    name(static_cast<AllocSubsystem>(i)), static_cast<double>(count) / frames,
+                    static_cast<double>(after.bytes[i] - before.bytes[i]) / frames);
+        }
+    }
+}
+
+#ifdef TETRIS_TRACK_ALLOCATIONS
+
+// SDL's own allocator, wrapped so SDL, SDL_ttf and SDL_mixer allocations are counted too
+static SDL_malloc_func originalMalloc;
+static SDL_calloc_func originalCalloc;
+static SDL_realloc_func originalRealloc;
+static SDL_free_func originalFree;
+
+static void* SDLCALL trackedMalloc(size_t size) {
+    AllocTracker::record(size);
+    return originalMalloc(size);
+}
+
+static void* SDLCALL trackedCalloc(size_t count, size_t size) {
+    AllocTracker::record(count * size);
+    return originalCalloc(count, size);
+}
+
+static void* SDLCALL trackedRealloc(void* memory, size_t size) {
+    AllocTracker::record(size);
+    return originalRealloc(memory, size);
+}
+
+static void SDLCALL trackedFree(void* memory) {
+    if (memory) {
+        AllocTracker::recordFree();
+    }
+    originalFree(memory);
+}
+
+void AllocTracker::install() {
+    SDL_GetOriginalMemoryFunctions(&originalMalloc, &originalCalloc, &originalRealloc, &originalFree);
+    SDL_SetMemoryFunctions(trackedMalloc, trackedCalloc, trackedRealloc, trackedFree);
+}
+
+// Global operator new and delete: every C++ allocation of the program goes through these (plain and array forms,
+// nothrow, and the sized and aligned forms when the language version has them)
+void* operator new(std::size_t size) {
+    AllocTracker::record(size);
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    AllocTracker::record(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept {
+    if (memory) {
+        AllocTracker::recordFree();
+        std::free(memory);
+    }
+}
+
+void operator delete[](void* memory) noexcept {
+    operator delete(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept {
+    operator delete(memory);
+}
+
+#ifdef __cpp_sized_deallocation
+// Sized delete (C++14): the size is not needed to free the block
+void operator delete(void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    operator delete(memory);
+}
+#endif
+
+#ifdef __cpp_aligned_new
+// Over-aligned new and delete (C++17), used for types declared with alignas above the default new alignment.
+// Without these, a C++17 build would send them to the library's own operators and they would not be counted
+static void* alignedAllocate(std::size_t size, std::align_val_t alignment) {
+    AllocTracker::record(size);
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if (align < sizeof(void*)) {
+        align = sizeof(void*);
+    }
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    void* memory = nullptr;
+    return posix_memalign(&memory, align, size ? size : 1) == 0 ? memory : nullptr;
+#endif
+}
+
+static void alignedRelease(void* memory) {
+    if (memory) {
+        AllocTracker::recordFree();
+#ifdef _WIN32
+        _aligned_free(memory);  // Blocks from _aligned_malloc cannot go to free()
+#else
+        std::free(memory);
+#endif
+    }
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    void* memory = alignedAllocate(size, alignment);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return alignedAllocate(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return alignedAllocate(size, alignment);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+    alignedRelease(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t) noexcept {
+    alignedRelease(memory);
+}
+
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    alignedRelease(memory);
+}
+
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept {
+    alignedRelease(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+    alignedRelease(memory);
+}
+
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept {
+    alignedRelease(memory);
+}
+#endif
+
+#else
+
+void AllocTracker::install() {
+}
+
+#endif
@@ -0,0 +1,63 @@
+// alloc_tracker.h
+
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <SDL3/SDL.h>   // Include SDL library for its integer types and memory hooks
+#include <cstddef>      // Include for size_t
+
+// Parts of the program allocations are charged to (the innermost AllocScope of the allocating thread)
+enum class AllocSubsystem { Other, Simulation, Render, Text, Audio, Capture, Solver, Count };
+
+// Totals since the program started, per subsystem
+struct AllocCounters {
+    Uint64 allocations[static_cast<int>(AllocSubsystem::Count)];  // Calls to new, malloc, calloc and realloc
+    Uint64 bytes[static_cast<int>(AllocSubsystem::Count)];        // Bytes requested by those calls
+    Uint64 frees;                                                 // Calls to delete and free
+};
+
+// AllocTracker counts heap allocations made through operator new and through SDL's allocator.
+// It is opt-in: the hooks only exist when the program is built with TETRIS_TRACK_ALLOCATIONS defined,
+// otherwise every count stays at zero and the scopes cost a thread-local write
+class AllocTracker {
+public:
+    // True if the program was built with the allocation hooks
+    static bool enabled();
+
+    // Routes SDL's allocations (SDL, SDL_ttf, SDL_mixer) through the counters; call before SDL_Init
+    static void install();
+
+    // Copies the current totals
+    static void snapshot(AllocCounters& counters);
+
+    // Name of a subsystem, for reports
+    static const char* name(AllocSubsystem subsystem);
+
+    // Total allocations between two snapshots, every subsystem included
+    static Uint64 allocationsBetween(const AllocCounters& before, const AllocCounters& after);
+
+    // Logs the allocations per frame of each subsystem that allocated between two snapshots
+    static void logPerFrame(const AllocCounters& before, const AllocCounters& after, Uint64 frames);
+
+    // Charges an allocation of 'bytes' to the calling thread's current subsystem (called by the hooks)
+    static void record(size_t bytes);
+
+    // Counts a release (called by the hooks)
+    static void recordFree();
+
+    // Subsystem the calling thread's allocations are charged to
+    static AllocSubsystem current();
+    static void setCurrent(AllocSubsystem subsystem);
+};
+
+// Charges the allocations made on this thread to a subsystem until the end of the scope
+class AllocScope {
+public:
+    explicit AllocScope(AllocSubsystem subsystem) : previous(AllocTracker::current()) { AllocTracker::setCurrent(subsystem); }
+    ~AllocScope() { AllocTracker::setCurrent(previous); }
+
+private:
+    AllocSubsystem previous;  // Restored when the scope ends (scopes nest)
+};
+
+#endif
@@ -3,6 +3,12 @@
 
 // Constructor: Initializes the AudioManager object.
 AudioManager::AudioManager() {
+    for (Mix_Music*& track : music) {
+        track = nullptr;
+    }
+    for (Mix_Chunk*& sound : sounds) {
+        sound = nullptr;
+    }
 }
 
 // Destructor: Cleans up allocated audio resources.
@@ -29,46 +35,46 @@ bool AudioManager::init() {
 
 // Loads all necessary sound effects and background music files.
 void AudioManager::loadAllSounds() {
-    loadMusic("background", "Sound_Effects/background.wav");
-    loadSound("move", "Sound_Effects/move.wav");
-    loadSound("rotate", "Sound_Effects/rotate.wav");
-    loadSound("line", "Sound_Effects/line.wav");
-    loadSound("4lines", "Sound_Effects/4_lines.wav");
-    loadSound("pieceLanded", "Sound_Effects/piece_landed.wav");
-    loadSound("gameover", "Sound_Effects/game_over.wav");
+    loadMusic(MusicId::Background, "Sound_Effects/background.wav");
+    loadSound(SoundId::Move, "Sound_Effects/move.wav");
+    loadSound(SoundId::Rotate, "Sound_Effects/rotate.wav");
+    loadSound(SoundId::Line, "Sound_Effects/line.wav");
+    loadSound(SoundId::FourLines, "Sound_Effects/4_lines.wav");
+    loadSound(SoundId::PieceLanded, "Sound_Effects/piece_landed.wav");
+    loadSound(SoundId::GameOver, "Sound_Effects/game_over.wav");
 }
 
-// Loads a music file and stores it in the music map.
-void AudioManager::loadMusic(const std::string& id, const std::string& filepath) {
-    Mix_Music* music = Mix_LoadMUS(filepath.c_str());  // Loads the music file.
-    if (!music) {
+// Loads a music file and stores it in its slot.
+void AudioManager::loadMusic(MusicId id, const std::string& filepath) {
+    Mix_Music* track = Mix_LoadMUS(filepath.c_str());  // Loads the music file.
+    if (!track) {
         game->displayErrorMessage("Error loading music: " + filepath);
     } else {
-        musicMap[id] = music;  // Stores the loaded music in the map.
+        music[static_cast<int>(id)] = track;  // Stores the loaded music in its slot.
     }
 }
 
-// Loads a sound effect file and stores it in the sound map.
-void AudioManager::loadSound(const std::string& id, const std::string& filepath) {
+// Loads a sound effect file and stores it in its slot.
+void AudioManager::loadSound(SoundId id, const std::string& filepath) {
     Mix_Chunk* sound = Mix_LoadWAV(filepath.c_str());  // Loads the sound effect file.
     if (!sound) {
         game->displayErrorMessage("Error loading sound: " + filepath);
     } else {
-        soundMap[id] = sound;  // Stores the loaded sound effect in the map.
+        sounds[static_cast<int>(id)] = sound;  // Stores the loaded sound effect in its slot.
     }
 }
 
 // Plays a music track with a given ID. Can loop multiple times.
-void AudioManager::playMusic(const std::string& id, int loops) {
-    if (musicMap.find(id) != musicMap.end()) {
-        Mix_PlayMusic(musicMap[id], loops);
+void AudioManager::playMusic(MusicId id, int loops) {
+    if (music[static_cast<int>(id)]) {
+        Mix_PlayMusic(music[static_cast<int>(id)], loops);
     }
 }
 
 // Plays a sound effect with a given ID.
-void AudioManager::playSound(const std::string& id) {
-    if (soundMap.find(id) != soundMap.end()) {
-        Mix_PlayChannel(-1, soundMap[id], 0);
+void AudioManager::playSound(SoundId id) {
+    if (sounds[static_cast<int>(id)]) {
+        Mix_PlayChannel(-1, sounds[static_cast<int>(id)], 0);
     }
 }
 
@@ -80,12 +86,14 @@ void AudioManager::stopMusic() {
 // Cleans up loaded audio resources to prevent memory leaks.
 void AudioManager::cleanUp() {
     // Free all loaded music tracks.
-    for (auto& pair : musicMap) {
-        Mix_FreeMusic(pair.second);
+    for (Mix_Music*& track : music) {
+        if (track) Mix_FreeMusic(track);
+        track = nullptr;
     }
     // Free all loaded sound effects.
-    for (auto& pair : soundMap) {
-        Mix_FreeChunk(pair.second);
+    for (Mix_Chunk*& sound : sounds) {
+        if (sound) Mix_FreeChunk(sound);
+        sound = nullptr;
     }
     // Closes the audio system.
     Mix_CloseAudio();
@@ -2,8 +2,7 @@
 #define AUDIO_MANAGER_H
 
 #include <SDL3_mixer/SDL_mixer.h>  // Include SDL_Mixer for audio functionality
-#include <string>  // Include string for managing file paths and IDs
-#include <map>  // Include map to store sound/music by ID
+#include <string>  // Include string for managing file paths
 #include <iostream>  // Include iostream for potential logging
 
 // Forward declarations of other classes
@@ -11,6 +10,10 @@ class Game;
 class Board;
 class Piece;
 
+// Sound effects and music tracks, used as indices so playing one never builds a string
+enum class SoundId { Move, Rotate, Line, FourLines, PieceLanded, GameOver, Count };
+enum class MusicId { Background, Count };
+
 // The AudioManager class handles all audio-related functionalities
 class AudioManager {
 public:
@@ -23,17 +26,17 @@ public:
     // Initializes SDL_Mixer and audio settings
     bool init();
     
-    // Loads a music file into the music map with a given ID
-    void loadMusic(const std::string& id, const std::string& filepath);
+    // Loads a music file into the music slot with a given ID
+    void loadMusic(MusicId id, const std::string& filepath);
     
-    // Loads a sound effect file into the sound map with a given ID
-    void loadSound(const std::string& id, const std::string& filepath);
+    // Loads a sound effect file into the sound slot with a given ID
+    void loadSound(SoundId id, const std::string& filepath);
     
     // Plays the music associated with the given ID. Loops indefinitely by default
-    void playMusic(const std::string& id, int loops = -1);
+    void playMusic(MusicId id, int loops = -1);
     
     // Plays the sound effect associated with the given ID
-    void playSound(const std::string& id);
+    void playSound(SoundId id);
     
     // Stops any currently playing music
     void stopMusic();
@@ -49,9 +52,9 @@ private:
     Board* board;  // Pointer to the board object (if needed)
     Piece* piece;  // Pointer to the piece object (if needed)
     
-    // Maps to store music and sound effect resources by their unique IDs
-    std::map<std::string, Mix_Music*> musicMap;
-    std::map<std::string, Mix_Chunk*> soundMap;
+    // Music and sound effect resources indexed by their IDs (null until loaded)
+    Mix_Music* music[static_cast<int>(MusicId::Count)];
+    Mix_Chunk* sounds[static_cast<int>(SoundId::Count)];
 };
 
 #endif
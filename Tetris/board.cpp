@@ -8,7 +8,21 @@
 // Constructor: Initializes the board with a grid, game, piece, and audio manager
 Board::Board(Game* g, Piece* p, AudioManager* a, int width, int height) : game(g), piece(p), audio(a), width(width), height(height) {
     // Initialize the grid to the given width and height, filled with transparent black cells
-    grid.resize(height, std::vector<SDL_Color>(width, {0, 0, 0, 0}));
+    clear();
+}
+
+// Empty the board: after the first call the storage already has the right size, so nothing is allocated
+void Board::clear() {
+    cells.assign(width * height, {0, 0, 0, 0});
+    rows.resize(height);
+    for (int y = 0; y < height; ++y) {
+        rows[y] = y;  // Storage rows start in board order
+    }
+    rowHead = 0;
+    rowFill.assign(height, 0);
+    stackTop = height;  // The board is empty
+    dirtyTop = height;  // Nothing written yet
+    dirtyBottom = -1;
     linesCleared = 0;  // Initialize the cleared lines counter
 }
 
@@ -19,96 +33,242 @@ Board::~Board() {
 // Draw the grid: Render each cell in the grid with its color, along with grid borders
 void Board::draw(SDL_Renderer* renderer) {
     for (int y = 0; y < height; ++y) { // Loop through each row
+        const SDL_Color* row = &cells[rowIndex(y) * width];
         for (int x = 0; x < width; ++x) { // Loop through each column
-            SDL_FRect rect = {static_cast<float>(x * CELL_SIZE), static_cast<float>(y * CELL_SIZE), static_cast<float>(CELL_SIZE), static_cast<float>(CELL_SIZE)};
+            drawCell(renderer, x, y, row[x]);
+        }
+    }
+}
 
-            // If the cell is not empty (color is not black), draw it
-            if (grid[y][x].r != 0 || grid[y][x].g != 0 || grid[y][x].b != 0) {
-                SDL_SetRenderDrawColor(renderer, grid[y][x].r, grid[y][x].g, grid[y][x].b, 255); // Set the cell color
-                SDL_RenderFillRect(renderer, &rect); // Fill the rectangle with the color
-            }
+// Draw a single cell: filled with its color if it is not empty, then its grid border
+void Board::drawCell(SDL_Renderer* renderer, int x, int y, SDL_Color color) {
+    SDL_FRect rect = {static_cast<float>(x * CELL_SIZE), static_cast<float>(y * CELL_SIZE), static_cast<float>(CELL_SIZE), static_cast<float>(CELL_SIZE)};
 
-            // Draw the grid border (light gray)
-            SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
-            SDL_RenderRect(renderer, &rect);
-        }
+    // If the cell is not empty (color is not black), draw it
+    if (color.r != 0 || color.g != 0 || color.b != 0) {
+        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, 255); // Set the cell color
+        SDL_RenderFillRect(renderer, &rect); // Fill the rectangle with the color
+    }
+
+    // Draw the grid border (light gray)
+    SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
+    SDL_RenderRect(renderer, &rect);
+}
+
+// Storage row of a board row: position y in the ring, counted from its head
+int Board::rowIndex(int y) const {
+    int slot = rowHead + y;
+    if (slot >= height) {
+        slot -= height;
     }
+    return rows[slot];
 }
 
 // Check if a specific line is full (no empty cells)
 bool Board::isFullLine(int y) {
-    for (int x = 0; x < width; x++) {
-        if (isCellEmpty(x, y)) { // If any cell is empty, return false
-            return false;
+    return rowFill[rowIndex(y)] == width;
+}
+
+// Remove rows: one pass over whichever side of the cleared rows holds fewer row indices to move.
+// Going up from the lowest cleared row, every row left is moved down by the number of cleared rows below it;
+// going down from the highest one, every row left is moved up by the number of cleared rows above it and the
+// ring is then turned back by 'count', which moves everything down by 'count'
+void Board::removeRows(const int* full, int count) {
+    int lowest = full[0];            // 'full' goes from the bottom up
+    int highest = full[count - 1];
+    int top = stackTop < highest ? stackTop : highest;  // Rows above the stack are all empty, so they never need to move
+    int freed[MAX_CLEAR];
+    int next = 0;                    // Next entry of 'full' to meet
+
+    if (lowest - top <= height - 1 - highest) {
+        int write = lowest;
+        for (int y = lowest; y >= top; --y) {
+            int row = rows[(rowHead + y) % height];
+            if (next < count && full[next] == y) {
+                freed[next++] = row;
+            } else {
+                rows[(rowHead + write--) % height] = row;
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            rows[(rowHead + write--) % height] = freed[i];  // The freed rows become the new top of the stack
+        }
+    } else {
+        int write = highest;
+        next = count - 1;
+        for (int y = highest; y < height; ++y) {
+            int row = rows[(rowHead + y) % height];
+            if (next >= 0 && full[next] == y) {
+                freed[next--] = row;
+            } else {
+                rows[(rowHead + write++) % height] = row;
+            }
+        }
+        for (int i = 0; i < count; ++i) {
+            rows[(rowHead + write++) % height] = freed[i];
         }
+        rowHead = (rowHead + height - count) % height;  // The freed rows wrap around to the top
     }
-    return true; // All cells are filled
+
+    // The freed storage rows are now empty rows
+    for (int i = 0; i < count; ++i) {
+        SDL_Color* row = &cells[freed[i] * width];
+        for (int x = 0; x < width; x++) {
+            row[x] = {0, 0, 0, 0}; // Set each cell to empty (black)
+        }
+        rowFill[freed[i]] = 0;
+    }
+
+    stackTop = stackTop + count < height ? stackTop + count : height;  // Everything above moved down by 'count'
 }
 
-// Clear full lines: If a line is full, shift all rows above it down and clear the top row
-void Board::clearFullLines() {
+// Clear full lines: only rows written since the last call can have become full, and they are removed together
+int Board::clearFullLines() {
     int lines = 0; // Variable to count the number of full lines
-    for (int y = height - 1; y >= 0; y--) { // Start checking from the bottom row
+    int full[MAX_CLEAR];
+    int batch = 0;
+    int top = dirtyTop;
+    for (int y = dirtyBottom; y >= top; --y) { // Start checking from the bottom row
         if (isFullLine(y)) { // If the line is full
-            lines++; // Increment the line count
-            
-            // Shift all rows above this one down
-            for (int row = y; row > 0; row--) {
-                for (int x = 0; x < width; x++) {
-                    grid[row][x] = grid[row - 1][x]; // Move the row down
-                }
-            }
-
-            // Clear the top row
-            for (int x = 0; x < width; x++) {
-                grid[0][x] = {0, 0, 0, 0}; // Set each cell to empty (black)
+            full[batch++] = y;
+            if (batch == MAX_CLEAR) {
+                // Only boards filled by hand clear this many rows at once: remove these, then carry on
+                // with the rows above, which have moved down by 'batch'
+                removeRows(full, batch);
+                lines += batch;
+                y += batch;
+                top += batch;
+                batch = 0;
             }
-            y++; // Skip checking the row that was just shifted down
         }
     }
+    if (batch > 0) {
+        removeRows(full, batch);
+        lines += batch;
+    }
+    dirtyTop = height;
+    dirtyBottom = -1;
 
-    // Update the score based on the number of lines cleared
     linesCleared += lines;
+
+    // Update the score based on the number of lines cleared
+    SoundId sound = SoundId::Line;
+    int points = 0;
     if (lines == 1) {
-        game->setScore(game->getScore() + 100);
-        audio->playSound("line"); // Play a sound for clearing a single line
+        points = 100;
+        sound = SoundId::Line; // Play a sound for clearing a single line
     }
     else if (lines == 2) {
-        game->setScore(game->getScore() + 300);
-        audio->playSound("line"); // Play a sound for clearing two lines
+        points = 300;
+        sound = SoundId::Line; // Play a sound for clearing two lines
     }
     else if (lines == 3) {
-        game->setScore(game->getScore() + 500);
-        audio->playSound("line"); // Play a sound for clearing three lines
+        points = 500;
+        sound = SoundId::Line; // Play a sound for clearing three lines
     } 
     else if (lines == 4) {
-        game->setScore(game->getScore() + 800);
-        audio->playSound("4lines"); // Play a special sound for clearing four lines
+        points = 800;
+        sound = SoundId::FourLines; // Play a special sound for clearing four lines
     }
+
+    // Boards used on their own (tools, benchmarks) have no game to score
+    if (points && game) {
+        game->setScore(game->getScore() + points);
+    }
+
+    // Boards of games without audio stay silent
+    if (points && audio) {
+        audio->playSound(sound);
+    }
+    return lines;
 }
 
 // Check if a specific cell is empty (color is transparent black)
 bool Board::isCellEmpty(int x, int y) {
-    return grid[y][x].r == 0 && grid[y][x].g == 0 && grid[y][x].b == 0;
+    return isEmptyColor(cells[rowIndex(y) * width + x]);
 }
 
 // Check if a given position is valid (within the grid bounds)
-bool Board::isValid(int x, int y) {
+bool Board::isValid(int x, int y) const {
     return x >= 0 && x < width && y >= 0 && y < height;
 }
 
 // Set the color of a specific cell
 void Board::setCell(int x, int y, SDL_Color color) {
     if (isValid(x, y)) {
-        grid[y][x] = color; // Set the cell to the given color
+        int row = rowIndex(y);
+        SDL_Color& cell = cells[row * width + x];
+        rowFill[row] += (isEmptyColor(cell) ? 0 : -1) + (isEmptyColor(color) ? 0 : 1); // Keep the row's fill count
+        cell = color; // Set the cell to the given color
+
+        // Remember which rows may have become full, and how high the stack goes
+        if (y < dirtyTop) dirtyTop = y;
+        if (y > dirtyBottom) dirtyBottom = y;
+        if (!isEmptyColor(color) && y < stackTop) stackTop = y;
     }
 }
 
 // Get the color of a specific cell (returns black if invalid position)
-SDL_Color Board::getCell(int x, int y) {
+SDL_Color Board::getCell(int x, int y) const {
     if (!isValid(x, y)) {
         return {0, 0, 0, 0}; // Return black for an invalid cell
     }
-    return grid[y][x]; // Return the color of the cell
+    return cells[rowIndex(y) * width + x]; // Return the color of the cell
+}
+
+// Insert garbage from the bottom: the top rows leave the ring and come back as the new bottom rows
+bool Board::insertGarbageLines(int count, int holeX) {
+    bool toppedOut = false;
+    SDL_Color gray = {128, 128, 128, 255};
+
+    for (int i = 0; i < count && i < height; ++i) {
+        int recycled = rowIndex(0);
+        toppedOut = toppedOut || rowFill[recycled] > 0;
+        rowHead = (rowHead + 1) % height;  // Every row moves up one; the old top row is now the bottom one
+
+        SDL_Color* row = &cells[recycled * width];
+        for (int x = 0; x < width; x++) {
+            row[x] = x == holeX ? SDL_Color{0, 0, 0, 0} : gray;
+        }
+        rowFill[recycled] = (holeX >= 0 && holeX < width) ? width - 1 : width;
+    }
+
+    // Everything moved up, including the rows that may still need a full-line check
+    stackTop = stackTop - count < 0 ? 0 : stackTop - count;
+    if (stackTop > height - count) stackTop = height - count < 0 ? 0 : height - count;
+    if (dirtyBottom >= 0) {
+        dirtyTop = dirtyTop - count < 0 ? 0 : dirtyTop - count;
+        dirtyBottom -= count;
+        if (dirtyBottom < 0) {
+            dirtyTop = height;
+            dirtyBottom = -1;
+        }
+    }
+    return !toppedOut;
 }
 
+// Stack height: rows above stackTop are known to be empty, so only rows from there down are looked at
+int Board::getStackHeight() {
+    for (int y = stackTop; y < height; ++y) {
+        if (rowFill[rowIndex(y)] > 0) {
+            return height - y;
+        }
+    }
+    return 0;
+}
+
+// Count holes: going down each column, every empty cell under the first filled one is a hole
+int Board::countHoles() {
+    int holes = 0;
+    for (int x = 0; x < width; ++x) {
+        bool covered = false;
+        for (int y = stackTop; y < height; ++y) {
+            if (!isCellEmpty(x, y)) {
+                covered = true;
+            } else if (covered) {
+                holes++;
+            }
+        }
+    }
+    return holes;
+}
@@ -23,21 +23,48 @@ public:
     
     // Methods for drawing the grid, checking cell validity, and handling full lines
     void draw(SDL_Renderer* renderer);  // Renders the board on the screen
+    static void drawCell(SDL_Renderer* renderer, int x, int y, SDL_Color color); // Renders one cell and its border
     void setCell(int x, int y, SDL_Color color); // Sets the color of a specific cell
-    bool isValid(int x, int y);  // Checks if a given cell is within the grid bounds
+    bool isValid(int x, int y) const;  // Checks if a given cell is within the grid bounds
     bool isCellEmpty(int x, int y); // Checks if a specific cell is empty
     bool isFullLine(int y);   // Checks if a given line (row) is full
-    void clearFullLines();    // Clears all full lines and updates the grid
-    SDL_Color getCell(int x, int y); // Gets the color of a specific cell
+    int clearFullLines();     // Clears all full lines and updates the grid; returns the number of lines cleared
+    void clear();             // Empties the board and resets its line counter (reuses the storage)
+    SDL_Color getCell(int x, int y) const; // Gets the color of a specific cell
+    int getStackHeight();     // Number of rows from the bottom up to the highest filled cell
+    int countHoles();         // Number of empty cells with a filled cell somewhere above them in the same column
+    
+    // Pushes 'count' garbage rows (gray, with one hole at column holeX) in from the bottom.
+    // Returns false if filled cells were pushed out of the top of the board
+    bool insertGarbageLines(int count, int holeX);
     
     // Getter methods for the board's width and height
     int getWidth() const { return width; }
     int getHeight() const { return height; }
+    
+    // Getter for the total number of lines cleared on this board
+    int getLinesCleared() const { return linesCleared; }
 
 private:
+    // Rows are stored in a circular buffer of row indices: clearing or inserting a row moves row indices
+    // instead of copying every cell of every row above it. Inserting k garbage rows costs O(k * width).
+    // Clearing k rows costs O(k * width) to empty them plus one pass over the indices on the cheaper side:
+    // O(min(rows from the top of the stack down to the lowest cleared row, rows below the highest one)).
+    // That is not O(k): a clear in the middle of a tall stack still moves about half of its row indices
+    static const int MAX_CLEAR = 16;  // Rows removed in one pass (a piece fills at most 4)
+
+    int rowIndex(int y) const;       // Storage row holding row y of the board (0 is the top)
+    void removeRows(const int* full, int count);  // Removes 'count' rows listed from the bottom up; rows above them move down
+    bool isEmptyColor(SDL_Color color) const { return color.r == 0 && color.g == 0 && color.b == 0; }
+
     int width, height;               // The dimensions of the grid
     int linesCleared;                // Counter for the number of lines cleared
-    std::vector<std::vector<SDL_Color>> grid; // 2D grid of SDL_Color to store each cell's color
+    std::vector<SDL_Color> cells;    // Cell colors, one storage row of 'width' cells after another
+    std::vector<int> rows;           // Ring of storage row indices, in board order starting at rowHead
+    int rowHead;                     // Position in 'rows' of the top row of the board
+    std::vector<int> rowFill;        // Number of filled cells in each storage row
+    int stackTop;                    // No filled cell above this row (may be lower than the actual top)
+    int dirtyTop, dirtyBottom;       // Rows written by setCell since the last clearFullLines
     Game* game;                      // Pointer to the Game instance (to interact with game logic)
     Piece* piece;                    // Pointer to the current Piece instance
     AudioManager* audio;             // Pointer to the AudioManager for sound effects
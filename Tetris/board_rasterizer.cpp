@@ -0,0 +1,110 @@
+// board_rasterizer.cpp
+
+#include "board_rasterizer.h"  // Includes the BoardRasterizer class
+
+#include <cstring>  // Include for memcpy
+
+// SSE2 is part of every x86-64 target, so the span fill can always use it there
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BOARD_RASTERIZER_SSE2
+#endif
+
+// Constructor: cells of at least one pixel
+BoardRasterizer::BoardRasterizer(int size) : cellSize(size < 1 ? 1 : size) {
+}
+
+Uint32 BoardRasterizer::pack(SDL_Color color) {
+    // Bytes in memory order R, G, B, A whatever the byte order of the machine
+    Uint8 bytes[4] = {color.r, color.g, color.b, 255};
+    Uint32 pixel;
+    std::memcpy(&pixel, bytes, sizeof(pixel));
+    return pixel;
+}
+
+void BoardRasterizer::fillSpan(Uint32* pixels, int count, Uint32 value) {
+    int i = 0;
+#ifdef BOARD_RASTERIZER_SSE2
+    // Four pixels per store, sixteen per iteration while the span is long enough
+    __m128i four = _mm_set1_epi32(static_cast<int>(value));
+    for (; i + 16 <= count; i += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), four);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i + 4), four);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i + 8), four);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i + 12), four);
+    }
+    for (; i + 4 <= count; i += 4) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), four);
+    }
+#endif
+    for (; i < count; ++i) {
+        pixels[i] = value;
+    }
+}
+
+void BoardRasterizer::draw(const FrameSnapshot& frame, Uint8* pixels, int pitch) {
+    int width = frame.width;
+    int height = frame.height;
+    const Uint32 black = pack({0, 0, 0, 255});
+    const Uint32 gray = pack({200, 200, 200, 255});  // Grid border, as in Board::drawCell
+
+    // Colors of every cell: board cells first, then the active piece on top (hidden once the game is over)
+    fills.resize(width * height);
+    borders.resize(width * height);
+    for (int i = 0; i < width * height; ++i) {
+        const SDL_Color& color = frame.cells[i];
+        bool empty = color.r == 0 && color.g == 0 && color.b == 0;
+        fills[i] = empty ? black : pack(color);
+        borders[i] = gray;
+    }
+    if (!frame.gameOver) {
+        for (const auto& block : frame.pieceBlocks) {
+            if (block.first >= 0 && block.first < width && block.second >= 0 && block.second < height) {
+                fills[block.second * width + block.first] = pack(frame.pieceColor);
+                borders[block.second * width + block.first] = black;  // Piece outline, as in Piece::drawBlock
+            }
+        }
+    }
+
+    // A row of cells has at most three different scanlines (top border, inside, bottom border):
+    // each is written once with span fills and the rows that repeat it are copied
+    int rowBytes = imageWidth(width) * 4;
+    bool outlined = cellSize >= 4;
+    for (int cy = 0; cy < height; ++cy) {
+        Uint8* top = pixels + static_cast<size_t>(cy) * cellSize * pitch;
+        const Uint32* cellFills = &fills[cy * width];
+        const Uint32* cellBorders = &borders[cy * width];
+        Uint32* first = reinterpret_cast<Uint32*>(top);
+
+        if (!outlined) {
+            // Cells too small for a border: solid squares
+            for (int cx = 0; cx < width; ++cx) {
+                fillSpan(first + cx * cellSize, cellSize, cellFills[cx]);
+            }
+            for (int oy = 1; oy < cellSize; ++oy) {
+                std::memcpy(top + oy * pitch, top, rowBytes);
+            }
+            continue;
+        }
+
+        // Top border: the whole width of each cell in its border color
+        for (int cx = 0; cx < width; ++cx) {
+            fillSpan(first + cx * cellSize, cellSize, cellBorders[cx]);
+        }
+
+        // Inside: border pixel, fill, border pixel
+        Uint32* inside = reinterpret_cast<Uint32*>(top + pitch);
+        for (int cx = 0; cx < width; ++cx) {
+            Uint32* cell = inside + cx * cellSize;
+            cell[0] = cellBorders[cx];
+            fillSpan(cell + 1, cellSize - 2, cellFills[cx]);
+            cell[cellSize - 1] = cellBorders[cx];
+        }
+        for (int oy = 2; oy < cellSize - 1; ++oy) {
+            std::memcpy(top + oy * pitch, inside, rowBytes);
+        }
+
+        // Bottom border: same as the top one
+        std::memcpy(top + (cellSize - 1) * pitch, top, rowBytes);
+    }
+}
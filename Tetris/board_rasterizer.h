@@ -0,0 +1,43 @@
+// board_rasterizer.h
+
+#ifndef BOARD_RASTERIZER_H
+#define BOARD_RASTERIZER_H
+
+#include <SDL3/SDL.h>   // Include SDL library for its integer and color types (no video subsystem is used)
+#include <vector>       // Include vector for the per-cell colors
+
+#include "board.h"      // Includes the Board class for the default cell size
+#include "game.h"       // Includes the FrameSnapshot structure that is drawn
+
+// BoardRasterizer draws a board snapshot into a caller-owned RGBA32 buffer (bytes R, G, B, A), without
+// any window, renderer or GPU. The image matches what Board::drawCell and Piece::drawBlock draw: cells of
+// 'cellSize' pixels on a black background, filled with their color, with a light gray border around board
+// cells and a black border around the blocks of the active piece (borders are left out below 4 pixels per cell).
+// Each scanline is written with vectorized span fills and repeated rows are copied. A rasterizer keeps scratch
+// storage between calls, so use one per thread
+class BoardRasterizer {
+public:
+    // Constructor: draws cells of 'cellSize' pixels (Board::CELL_SIZE gives the game's own layout)
+    explicit BoardRasterizer(int cellSize = Board::CELL_SIZE);
+
+    // Size in pixels of the image of a board with the given number of columns or rows
+    int imageWidth(int boardWidth) const { return boardWidth * cellSize; }
+    int imageHeight(int boardHeight) const { return boardHeight * cellSize; }
+
+    // Draws the snapshot at the top-left of 'pixels', which holds rows of 'pitch' bytes (a multiple of 4)
+    // and at least imageWidth(frame.width) x imageHeight(frame.height) pixels
+    void draw(const FrameSnapshot& frame, Uint8* pixels, int pitch);
+
+    // Fills 'count' pixels with the same value (SSE2 stores when available)
+    static void fillSpan(Uint32* pixels, int count, Uint32 value);
+
+    // Packs a color into one RGBA32 pixel, fully opaque
+    static Uint32 pack(SDL_Color color);
+
+private:
+    int cellSize;                  // Pixels per cell side
+    std::vector<Uint32> fills;     // Inside color of each cell of the board being drawn
+    std::vector<Uint32> borders;   // Border color of each cell of the board being drawn
+};
+
+#endif
@@ -0,0 +1,187 @@
+// frame_capture.cpp
+
+#include "frame_capture.h"  // Includes the FrameCapture class
+#include "alloc_tracker.h"  // Includes the allocation counters (opt-in)
+
+FrameCapture::FrameCapture() : width(0), height(0), spareBuffer(-1), missed(0), trailingMissed(0), frameReady(nullptr), thread(nullptr), running(false), file(nullptr),
+                               captured(0), dropped(0), rejected(0), totalCostNS(0), worstCostNS(0), written(0), repeated(0), writeFailed(false) {
+}
+
+FrameCapture::~FrameCapture() {
+    stop();
+}
+
+bool FrameCapture::start(const std::string& path, int w, int h, int fps) {
+    stop();
+
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    width = w;
+    height = h;
+
+    // Raw 4:2:0 video, square pixels, progressive
+    if (std::fprintf(file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", width, height, fps) < 0) {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+
+    // Allocate every buffer now so capturing never allocates
+    buffers.assign(POOL_SIZE, std::vector<Uint8>(width * height * 4));
+    for (int i = 0; i < POOL_SIZE; ++i) {
+        freeBuffers.push(i);
+    }
+
+    spareBuffer = -1;
+    missed = trailingMissed = 0;
+    captured = dropped = rejected = totalCostNS = worstCostNS = written = repeated = 0;
+    writeFailed = false;
+    frameReady = SDL_CreateSemaphore(0);
+    running = true;
+    thread = frameReady ? SDL_CreateThread(writerThread, "capture writer", this) : nullptr;
+    if (!thread) {
+        // Without a writer nothing would ever free a buffer: give up instead of recording nothing
+        running = false;
+        if (frameReady) {
+            SDL_DestroySemaphore(frameReady);
+            frameReady = nullptr;
+        }
+        std::fclose(file);
+        file = nullptr;
+        buffers.clear();
+        int index;
+        while (freeBuffers.pop(index)) {}
+        return false;
+    }
+    return true;
+}
+
+void FrameCapture::capture(SDL_Renderer* renderer) {
+    AllocScope scope(AllocSubsystem::Capture);  // SDL_RenderReadPixels returns a new surface every frame (see the header)
+    Uint64 begin = SDL_GetTicksNS();
+
+    // No free buffer: the writer is behind, drop this frame rather than wait
+    int index = spareBuffer;
+    spareBuffer = -1;
+    if (index < 0 && !freeBuffers.pop(index)) {
+        dropped++;
+        missed++;
+        return;
+    }
+
+    // The one allocation per captured frame: SDL only reads back into a surface it creates
+    SDL_Surface* surface = SDL_RenderReadPixels(renderer, NULL);
+    if (!surface || surface->w != width || surface->h != height) {
+        // Nothing usable to record (or the output size changed): keep the buffer for the next frame
+        if (surface && rejected == 0) {
+            SDL_Log("Capture: the renderer output is %dx%d instead of %dx%d, frames of that size are not recorded",
+                    surface->w, surface->h, width, height);
+        }
+        if (surface) SDL_DestroySurface(surface);
+        rejected++;
+        missed++;
+        spareBuffer = index;
+        return;
+    }
+    SDL_ConvertPixels(width, height, surface->format, surface->pixels, surface->pitch,
+                      SDL_PIXELFORMAT_RGBA32, buffers[index].data(), width * 4);
+    SDL_DestroySurface(surface);
+
+    repeats[index] = missed;  // Published with the buffer index
+    missed = 0;
+    filledBuffers.push(index);
+    SDL_SignalSemaphore(frameReady);
+    captured++;
+
+    Uint64 cost = SDL_GetTicksNS() - begin;
+    totalCostNS += cost;
+    if (cost > worstCostNS) worstCostNS = cost;
+}
+
+void FrameCapture::stop() {
+    if (!file) {
+        return;
+    }
+
+    // The writer drains the queued frames before it exits, then repeats the last one for the frames missed since
+    trailingMissed = missed;
+    running = false;
+    SDL_SignalSemaphore(frameReady);
+    SDL_WaitThread(thread, NULL);
+    thread = nullptr;
+    SDL_DestroySemaphore(frameReady);
+    frameReady = nullptr;
+
+    if (std::fclose(file) != 0) {
+        writeFailed = true;  // The last buffered frames could not be flushed
+    }
+    file = nullptr;
+    buffers.clear();
+
+    // Drop the leftover buffer indices so a later start() begins from an empty pool
+    int index;
+    while (freeBuffers.pop(index)) {}
+
+    Uint64 frames = captured + dropped + rejected;
+    SDL_Log("Capture: %llu frames written (%llu repeating the previous frame), %llu dropped because the writer was behind (%.1f%%), "
+            "%llu not read back, capture cost %.3f ms/frame on average, %.3f ms worst",
+            static_cast<unsigned long long>(written), static_cast<unsigned long long>(repeated), static_cast<unsigned long long>(dropped),
+            frames ? 100.0 * dropped / frames : 0.0, static_cast<unsigned long long>(rejected),
+            captured ? totalCostNS / 1e6 / captured : 0.0, worstCostNS / 1e6);
+    if (writeFailed) {
+        SDL_Log("Capture: writing the video failed after %llu frames, the file is incomplete", static_cast<unsigned long long>(written));
+    }
+}
+
+int FrameCapture::writerThread(void* data) {
+    static_cast<FrameCapture*>(data)->writeFrames();
+    return 0;
+}
+
+void FrameCapture::writeFrames() {
+    // Planar YUV 4:2:0 frame, reused for every frame; it holds the last frame written, for the repeats
+    std::vector<Uint8> yuv(width * height * 3 / 2);
+    bool haveFrame = false;
+
+    for (;;) {
+        int index;
+        if (!filledBuffers.pop(index)) {
+            if (!running) {
+                break;  // Stopped and nothing left to write
+            }
+            SDL_WaitSemaphoreTimeout(frameReady, 100);
+            continue;
+        }
+
+        // Stand in for the frames missed before this one with the previous frame, so the timing is kept
+        for (int i = 0; i < repeats[index] && haveFrame; ++i) {
+            writeFrame(yuv);
+            repeated++;
+        }
+
+        SDL_ConvertPixels(width, height, SDL_PIXELFORMAT_RGBA32, buffers[index].data(), width * 4,
+                          SDL_PIXELFORMAT_IYUV, yuv.data(), width);
+        freeBuffers.push(index);  // The render loop can reuse the buffer as soon as it is converted
+        writeFrame(yuv);
+        haveFrame = true;
+    }
+
+    for (int i = 0; i < trailingMissed && haveFrame; ++i) {
+        writeFrame(yuv);
+        repeated++;
+    }
+}
+
+void FrameCapture::writeFrame(const std::vector<Uint8>& yuv) {
+    // After a write error (disk full, ...) the queue is still drained so the render loop never stalls
+    if (writeFailed) {
+        return;
+    }
+    if (std::fputs("FRAME\n", file) < 0 || std::fwrite(yuv.data(), 1, yuv.size(), file) != yuv.size()) {
+        writeFailed = true;
+        return;
+    }
+    written++;
+}
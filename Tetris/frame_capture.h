@@ -0,0 +1,78 @@
+// frame_capture.h
+
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <SDL3/SDL.h>   // Include SDL library for reading back the renderer and the writer thread
+#include <atomic>       // Include atomic for the flag shared with the writer thread
+#include <cstdio>       // Include for the output file
+#include <string>       // Include string for the output path
+#include <vector>       // Include vector for the pixel buffers
+
+#include "spsc_queue.h" // Lock-free hand-off of pixel buffers between the game and the writer thread
+
+// FrameCapture records presented frames to a raw Y4M video.
+// The render loop only copies the frame into one of a fixed pool of reusable buffers; a writer thread
+// converts it to YUV and streams it to disk. If the writer falls behind and no buffer is free,
+// the frame is dropped (and counted) instead of making the render loop wait. Every frame missed that way (or
+// not read back) is written as a repeat of the frame before it, so the video keeps one frame per presented
+// frame and plays back at the session's speed; only frames missed before the first captured one are lost.
+// Capturing is not allocation-free: SDL_RenderReadPixels has no form that reads into caller memory, so every
+// captured frame still allocates one SDL_Surface (width * height * 4 bytes of pixels) on the render thread and
+// frees it after the copy. It is charged to AllocSubsystem::Capture; nothing else in the path allocates
+class FrameCapture {
+public:
+    FrameCapture();
+    ~FrameCapture();
+
+    // Opens the output file, writes the Y4M header, allocates the buffers and starts the writer thread;
+    // returns false (and leaves nothing open) if any of it fails. 'width' and 'height' are the renderer's
+    // output size in pixels (SDL_GetRenderOutputSize), which is what capture() reads back
+    bool start(const std::string& path, int width, int height, int fps);
+
+    // Copies the current render target into a free buffer; call after drawing and before presenting
+    void capture(SDL_Renderer* renderer);
+
+    // Lets the writer finish the queued frames, stops it and logs the capture statistics
+    void stop();
+
+    // Checks if a capture is running
+    bool isRunning() const { return file != nullptr; }
+
+private:
+    // Writer thread loop
+    void writeFrames();
+
+    // Writes one YUV frame unless a write already failed (writer thread)
+    void writeFrame(const std::vector<Uint8>& yuv);
+    static int writerThread(void* data);
+
+    static const int POOL_SIZE = 8;  // Frames that can wait for the writer
+
+    int width, height;                             // Dimensions of the captured frames
+    std::vector<std::vector<Uint8>> buffers;       // RGBA pixels of each pooled frame
+    SpscQueue<int, POOL_SIZE + 1> freeBuffers;     // Writer -> render loop: buffers ready to be filled
+    SpscQueue<int, POOL_SIZE + 1> filledBuffers;   // Render loop -> writer: frames ready to be written
+    int spareBuffer;                               // Buffer taken but not used by the last capture (-1 if none)
+    int repeats[POOL_SIZE];                        // Frames missed just before the frame in each buffer
+    int missed;                                    // Frames missed since the last queued frame (render loop side)
+    int trailingMissed;                            // Frames missed after the last queued frame, set by stop()
+    SDL_Semaphore* frameReady;                     // Wakes the writer when a frame is queued
+    SDL_Thread* thread;                            // Writer thread
+    std::atomic<bool> running;                     // Cleared to stop the writer once the queue is empty
+    FILE* file;                                    // Output file
+
+    // Statistics (render loop side)
+    Uint64 captured;        // Frames handed to the writer
+    Uint64 dropped;         // Frames dropped because no buffer was free
+    Uint64 rejected;        // Frames not read back, or read back at another size than the one started with
+    Uint64 totalCostNS;     // Time spent in capture()
+    Uint64 worstCostNS;     // Longest capture() call
+
+    // Statistics (writer side)
+    Uint64 written;         // Frames written to disk, repeats included
+    Uint64 repeated;        // Repeats written in place of missed frames
+    std::atomic<bool> writeFailed;  // Set on the first failed write; later frames are not written
+};
+
+#endif
@@ -4,39 +4,81 @@
 #include "board.h"      // Includes the Board class which represents the game grid
 #include "piece.h"      // Includes the Piece class which represents the Tetris pieces
 #include "audio_manager.h" // Includes the AudioManager class for managing sounds and music
+#include "telemetry.h"  // Includes the shared memory telemetry ring
+#include "frame_capture.h" // Includes the FrameCapture class for recording the game
+#include "perfect_clear.h" // Includes the PerfectClearSolver class for the hint
+#include "piece_stats.h" // Includes the per-piece statistics file writer
+#include "game_state.h" // Includes the GameState structure for saving and loading
+#include "alloc_tracker.h" // Includes the allocation counters (opt-in)
+
+// Texts shown by render(), rendered ahead of time by prepareText()
+static const char* const SCORE_TEXT = "Score:";
+static const char* const GAME_OVER_TEXT = "=== Game Over===";
+static const char* const RESTART_TEXT = "Press 'esc' to quit or 'r' to restart";
+
+Game::Game() : Game(static_cast<Uint32>(std::time(nullptr)), true) {  // Seed the piece generator with the current time
+}
 
-Game::Game() {
-    std::srand(std::time(nullptr));  // Initialize random number generator based on the current time
-    audio = new AudioManager();      // Initialize the audio manager
-    
-    // Define the different types of Tetris pieces
-    PieceType types[] = {PieceType::I, PieceType::O, PieceType::T, PieceType::L, 
-                         PieceType::J, PieceType::S, PieceType::Z};
-    PieceType randomType = types[std::rand() % 7];  // Select a random piece type
+Game::Game(Uint32 seed, bool withAudio) {
+    rngState = seed ? seed : 1;  // xorshift must never be seeded with zero
+    garbageRng = rngState ^ 0x9e3779b9u;
+    garbageSent = 0;
+    garbageReceived = 0;
+    audio = withAudio ? new AudioManager() : nullptr;  // Initialize the audio manager
     
-    piece = new Piece(this, nullptr, 4, 0, randomType);  // Create a new piece with the random type
+    piece = new Piece(this, nullptr, 4, 0, randomPieceType());  // Create a new piece with a random type
+
+    // Fill the queue of upcoming pieces
+    queueHead = 0;
+    for (int i = 0; i < QUEUE_SIZE; ++i) {
+        nextPieces[i] = randomPieceType();
+    }
     board = new Board(this, piece, audio, grid_Width, grid_Height);  // Create the game board and pass the piece and audio manager
     piece->setBoard(board);  // Set the board for the piece
 
     // Initialize other game parameters
     score = 0;
     speed = 500;
+    piecesSpawned = 1;
     gameOver = false;
     run = true;
+    redraw = true;
     fillProgress = 0;
     isFilling = false;
+    fillStartTime = 0;
     once = false;
+    simRunning = false;
+    renderIdle = false;
+    wakeEvent = 0;
+    stateChanged = true;
+    lastGravityTime = 0;
+    tickCount = 0;
+    telemetry = nullptr;
+    tickInputCount = 0;
+    pieceStats = nullptr;
+    tickTime = 0;
+    pieceSpawnTime = 0;
+    solver = nullptr;
+    hintPiece = 0;
+    hintRequestPiece = -1;
 
     // Initialize audio, load sounds, and play background music
-    audio->init();
-    audio->loadAllSounds();
-    audio->playMusic("background", -1);
+    initAudio();
+    playMusic();
 }
 
 Game::~Game() {
     delete board;  // Clean up dynamically allocated board object
     delete piece;  // Clean up dynamically allocated piece object
     delete audio;  // Clean up dynamically allocated audio manager
+    delete telemetry;  // Clean up the telemetry writer (if any)
+    delete solver;  // Stop the solver threads (if a hint was ever asked for)
+}
+
+// Entry point of the simulation thread
+static int simulationThread(void* data) {
+    static_cast<Game*>(data)->runSimulation();
+    return 0;
 }
 
 void Game::start() {    
@@ -46,48 +88,101 @@ void Game::start() {
     // Create a new SDL window and renderer
     SDL_Window *window = SDL_CreateWindow("Tetris", win_Width, win_Height, 0);
     SDL_Renderer *renderer = SDL_CreateRenderer(window, NULL);
+    SDL_SetRenderVSync(renderer, 1);  // Pace presentation to the display refresh rate
+    wakeEvent = SDL_RegisterEvents(1);  // Event used by the simulation to wake an idle render loop
+    prepareText(renderer);  // Render the texts once, before the first frame
+
+    // Start recording if requested, at the display's refresh rate since every vsync'd frame is captured
+    FrameCapture* capture = nullptr;
+    if (!capturePath.empty()) {
+        const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+        int fps = (mode && mode->refresh_rate > 0) ? static_cast<int>(mode->refresh_rate + 0.5f) : 60;
+        // Frames are read back in output pixels, which differ from the window size on high-DPI displays
+        int outputWidth = win_Width, outputHeight = win_Height;
+        SDL_GetRenderOutputSize(renderer, &outputWidth, &outputHeight);
+        capture = new FrameCapture();
+        if (!capture->start(capturePath, outputWidth, outputHeight, fps)) {
+            displayErrorMessage("Could not start recording to " + capturePath);
+            delete capture;
+            capture = nullptr;
+        }
+    }
+
+    // Publish the initial state, then hand the simulation over to its own thread
+    lastGravityTime = SDL_GetTicks();
+    publishFrame();
+    simRunning = true;
+    SDL_Thread* simThread = SDL_CreateThread(simulationThread, "simulation", this);
 
-    // Main game loop
+    // Allocations per frame, logged every second when the allocation hooks are built in
+    AllocCounters allocBefore, allocNow;
+    AllocTracker::snapshot(allocBefore);
+    Uint64 framesSinceReport = 0;
+    Uint64 lastReport = SDL_GetTicks();
+
+    // Render loop: draws the latest snapshot whenever a new one is available
+    redraw = true;  // Draw the first frame whatever the simulation has published
     while(run) {
         handleEvents();  // Handle user input (events)
-        
-        // Clear the screen and set drawing color
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);    
+        if (!run) {
+            break;
+        }
 
-        render(renderer);  // Render the game state
-        
-        // If the game is over, display "Game Over" and the restart message
-        if(gameOver) {
-            displayText(renderer, "=== Game Over===", scoreX, scoreY + 40, {255, 0, 0, 255}, 48);
-            displayText(renderer, "Press 'esc' to quit or 'r' to restart", scoreX, scoreY + 120, {255, 255, 255, 255}, 24);
-            audio->stopMusic();  // Stop the background music
-            if(!once) {
-                audio->playSound("gameover");  // Play the game over sound once
-                once = true;
+        // While recording, every vsync'd frame is drawn so the video keeps a constant frame rate
+        if (frames.fetch() || redraw || capture) {
+            AllocScope scope(AllocSubsystem::Render);
+            redraw = false;
+            const FrameSnapshot& frame = frames.readBuffer();
+
+            // Clear the screen and set drawing color
+            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+            SDL_RenderClear(renderer);    
+
+            render(renderer, frame);  // Render the game state
+
+            if (capture) {
+                capture->capture(renderer);  // Hand a copy of the frame to the capture writer
             }
-        }
-        
-        // Game loop continues until the game is over
-        while (!gameOver) {   
-            handleEvents();  // Handle events during game play
-            update();  // Update the game state (piece movement, collisions, etc.)
 
-            SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);  // Set the background color
-            SDL_RenderClear(renderer);  // Clear the screen
+            SDL_RenderPresent(renderer);  // Present the frame (paced by vsync)
 
-            render(renderer);  // Render the current game state
+            framesSinceReport++;
+            if (AllocTracker::enabled() && SDL_GetTicks() - lastReport >= 1000) {
+                AllocTracker::snapshot(allocNow);
+                AllocTracker::logPerFrame(allocBefore, allocNow, framesSinceReport);
+                allocBefore = allocNow;
+                framesSinceReport = 0;
+                lastReport = SDL_GetTicks();
+            }
+        } else {
+            // Nothing new to show: sleep until an event arrives or the simulation publishes a frame.
+            // The flag is checked again after being raised so a frame published in between is not missed.
+            renderIdle = true;
+            if (frames.hasNew()) {
+                renderIdle = false;
+                continue;
+            }
+            SDL_Event event;
+            if (SDL_WaitEvent(&event)) {
+                renderIdle = false;
+                processEvent(event);
+            }
+            renderIdle = false;
+        }
+    }
 
-            SDL_RenderPresent(renderer);  // Present the rendered frame to the screen
-            SDL_Delay(speed);  // Delay to control game speed
-        }    
-        
-        SDL_RenderPresent(renderer);  // Present the last frame when game is over
+    // Stop the simulation thread before tearing anything down
+    simRunning = false;
+    SDL_WaitThread(simThread, NULL);
 
-        SDL_Event event;  // Event variable to capture events
+    // Finish writing the recording (logs the capture statistics)
+    if (capture) {
+        capture->stop();
+        delete capture;
     }
 
     // Clean up SDL resources
+    clearTextCache();
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     TTF_Quit();
@@ -97,43 +192,418 @@ void Game::start() {
 void Game::handleEvents() {
     SDL_Event event;
     while (SDL_PollEvent(&event)) {  // Poll all events
-        switch (event.type) {
-            case SDL_EVENT_QUIT:  // Handle window close event
-                gameOver = true;
-                run = false;
-                break;
-
-            case SDL_EVENT_KEY_DOWN:  // Handle key press events
-                switch (event.key.key) {
-                    case SDLK_ESCAPE:  // Escape key to quit
-                        gameOver = true;
-                        run = false;
-                        break;
-                    case SDLK_R:  // 'R' key to reset the game
-                        resetGame();
-                        return;  // Exit handle events function after reset
-                    case SDLK_A:  // 'A' key to move piece left
-                        if (!gameOver) piece->movePiece(-1, 0);
-                        audio->playSound("move");
-                        break;
-                    case SDLK_D:  // 'D' key to move piece right
-                        if (!gameOver) piece->movePiece(1, 0);
-                        audio->playSound("move");
-                        break;
-                    case SDLK_S:  // 'S' key to move piece down
-                        if (!gameOver) piece->movePiece(0, 1);
-                        audio->playSound("move");
-                        break;
-                    case SDLK_W:  // 'W' key to rotate piece
-                        if (!gameOver) piece->rotatePiece();
-                        audio->playSound("rotate");
-                        break;
-                    default:
-                        break;                         
-                }
-                break;                
+        if (!processEvent(event)) {
+            return;  // Exit handle events function after reset
+        }
+    }
+}
+
+bool Game::processEvent(const SDL_Event& event) {
+    // Runs on the render thread: game actions are queued for the simulation thread.
+    // A full queue drops the action rather than waiting for the simulation to catch up.
+    switch (event.type) {
+        case SDL_EVENT_QUIT:  // Handle window close event
+            run = false;
+            break;
+
+        case SDL_EVENT_WINDOW_EXPOSED:  // The window contents were lost: draw the current frame again
+            redraw = true;
+            break;
+
+        case SDL_EVENT_KEY_DOWN:  // Handle key press events
+            switch (event.key.key) {
+                case SDLK_ESCAPE:  // Escape key to quit
+                    run = false;
+                    break;
+                case SDLK_R:  // 'R' key to reset the game
+                    inputQueue.push(InputAction::Reset);
+                    return false;  // Skip the remaining events after reset
+                case SDLK_A:  // 'A' key to move piece left
+                    inputQueue.push(InputAction::MoveLeft);
+                    break;
+                case SDLK_D:  // 'D' key to move piece right
+                    inputQueue.push(InputAction::MoveRight);
+                    break;
+                case SDLK_S:  // 'S' key to move piece down
+                    inputQueue.push(InputAction::MoveDown);
+                    break;
+                case SDLK_W:  // 'W' key to rotate piece
+                    inputQueue.push(InputAction::Rotate);
+                    break;
+                case SDLK_H:  // 'H' key to show a perfect clear hint
+                    inputQueue.push(InputAction::Hint);
+                    break;
+                default:
+                    break;                         
+            }
+            break;                
+    }
+    return true;
+}
+
+void Game::applyInput(InputAction action) {
+    switch (action) {
+        case InputAction::Reset:
+            resetGame();
+            break;
+        case InputAction::MoveLeft:
+            if (!gameOver) piece->movePiece(-1, 0);
+            playSound(SoundId::Move);
+            break;
+        case InputAction::MoveRight:
+            if (!gameOver) piece->movePiece(1, 0);
+            playSound(SoundId::Move);
+            break;
+        case InputAction::MoveDown:
+            if (!gameOver) piece->movePiece(0, 1);
+            playSound(SoundId::Move);
+            break;
+        case InputAction::Rotate:
+            if (!gameOver) piece->rotatePiece();
+            playSound(SoundId::Rotate);
+            break;
+        case InputAction::Hint:
+            if (!gameOver) showPerfectClearHint();
+            break;
+    }
+    stateChanged = true;
+}
+
+void Game::simulationTick(Uint64 now) {
+    AllocScope scope(AllocSubsystem::Simulation);
+    tickTime = now;
+    if (tickCount == 0) {
+        pieceSpawnTime = now;  // The first piece was spawned before the clock started
+    }
+
+    // Apply every action the render thread queued since the last tick
+    InputAction action;
+    tickInputCount = 0;
+    while (inputQueue.pop(action)) {
+        if (tickInputCount < MAX_TICK_INPUTS) {
+            tickInputs[tickInputCount++] = static_cast<Uint8>(action);
+        }
+        applyInput(action);
+        if (action == InputAction::Reset) {
+            lastGravityTime = now;
+        }
+    }
+    collectPerfectClearHint();
+
+    if (!gameOver) {
+        applyGravity(now);
+    } else {
+        if (!once) {
+            stopMusic();  // Stop the background music
+            playSound(SoundId::GameOver);  // Play the game over sound once
+            once = true;
+            stateChanged = true;
+        }
+        if (fillGridAnimation(now)) {
+            stateChanged = true;
+        }
+    }
+
+    tickCount++;
+    if (telemetry) {
+        publishTelemetry();  // Published every tick, changed or not
+    }
+
+    // Only publish when something changed so an idle render thread can stay asleep
+    if (stateChanged) {
+        publishFrame();
+        stateChanged = false;
+
+        // Wake the render thread if it went to sleep waiting for events
+        if (renderIdle.exchange(false)) {
+            SDL_Event event;
+            SDL_zero(event);
+            event.type = wakeEvent;
+            SDL_PushEvent(&event);
+        }
+    }
+}
+
+void Game::applyGravity(Uint64 now) {
+    // Gravity: move the piece down once every 'speed' milliseconds
+    if (now - lastGravityTime >= static_cast<Uint64>(speed)) {
+        update();
+        lastGravityTime = now;
+        stateChanged = true;
+    }
+}
+
+void Game::saveState(GameState& state) const {
+    state.board = *board;
+    state.pieceX = piece->getPieceX();
+    state.pieceY = piece->getPieceY();
+    state.pieceType = piece->getType();
+    state.pieceRotation = piece->getRotation();
+    state.score = score;
+    state.speed = speed;
+    state.piecesSpawned = piecesSpawned;
+    state.rngState = rngState;
+    for (int i = 0; i < QUEUE_SIZE; ++i) {
+        state.nextPieces[i] = nextPieces[i];
+    }
+    state.queueHead = queueHead;
+    state.gameOver = gameOver;
+    state.lastGravityTime = lastGravityTime;
+    state.garbageSent = garbageSent;
+    state.garbageReceived = garbageReceived;
+    state.garbageRng = garbageRng;
+}
+
+void Game::loadState(const GameState& state) {
+    *board = state.board;  // Same dimensions, so the cell storage is reused
+    piece->reset(state.pieceX, state.pieceY, state.pieceType, state.pieceRotation);
+    score = state.score;
+    speed = state.speed;
+    piecesSpawned = state.piecesSpawned;
+    rngState = state.rngState;
+    for (int i = 0; i < QUEUE_SIZE; ++i) {
+        nextPieces[i] = state.nextPieces[i];
+    }
+    queueHead = state.queueHead;
+    gameOver = state.gameOver;
+    lastGravityTime = state.lastGravityTime;
+    garbageSent = state.garbageSent;
+    garbageReceived = state.garbageReceived;
+    garbageRng = state.garbageRng;
+    hintBlocks.clear();
+    stateChanged = true;
+}
+
+int Game::takeGarbageSent() {
+    int lines = garbageSent;
+    garbageSent = 0;
+    return lines;
+}
+
+void Game::receiveGarbage(int lines) {
+    garbageReceived += lines;
+}
+
+Uint32 GameState::checksum() const {
+    // FNV-1a over the cells, the active piece and every counter that affects what happens next
+    Uint32 hash = 2166136261u;
+    auto mix = [&hash](Uint32 value) {
+        for (int i = 0; i < 4; ++i) {
+            hash = (hash ^ ((value >> (8 * i)) & 0xff)) * 16777619u;
+        }
+    };
+    for (int y = 0; y < board.getHeight(); ++y) {
+        for (int x = 0; x < board.getWidth(); ++x) {
+            SDL_Color c = board.getCell(x, y);
+            mix((static_cast<Uint32>(c.r) << 16) | (static_cast<Uint32>(c.g) << 8) | c.b);
+        }
+    }
+    mix(static_cast<Uint32>(board.getLinesCleared()));
+    mix(static_cast<Uint32>(pieceX));
+    mix(static_cast<Uint32>(pieceY));
+    mix(static_cast<Uint32>(pieceType));
+    mix(static_cast<Uint32>(pieceRotation));
+    mix(static_cast<Uint32>(score));
+    mix(static_cast<Uint32>(speed));
+    mix(static_cast<Uint32>(piecesSpawned));
+    mix(rngState);
+    for (int i = 0; i < Game::QUEUE_SIZE; ++i) {
+        mix(static_cast<Uint32>(nextPieces[(queueHead + i) % Game::QUEUE_SIZE]));
+    }
+    mix(gameOver ? 1 : 0);
+    mix(static_cast<Uint32>(lastGravityTime));
+    mix(static_cast<Uint32>(garbageSent));
+    mix(static_cast<Uint32>(garbageReceived));
+    mix(garbageRng);
+    return hash;
+}
+
+bool Game::enableTelemetry(const std::string& name) {
+    if (!telemetry) {
+        telemetry = new TelemetryWriter();
+    }
+    if (!telemetry->open(name)) {
+        delete telemetry;
+        telemetry = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void Game::setPieceStats(PieceStatsWriter* writer) {
+    pieceStats = writer;
+    if (pieceStats) {
+        pieceStats->startGame();
+    }
+}
+
+void Game::recordPiece(int lines, int scoreDelta, int pieceSpeed) {
+    PieceStatsRecord record;
+    record.game = 0;  // Set by the writer
+    record.piece = piecesSpawned;
+    record.type = static_cast<Sint32>(piece->getType());
+    record.x = piece->getPieceX();
+    record.y = piece->getPieceY();
+    record.rotation = piece->getRotation();
+    record.lines = lines;
+    record.scoreDelta = scoreDelta;
+    record.score = score;
+    record.speed = pieceSpeed;
+    record.lockTime = static_cast<Sint32>(tickTime - pieceSpawnTime);
+    record.height = board->getStackHeight();
+    record.holes = board->countHoles();
+    pieceStats->append(record);
+}
+
+void Game::publishTelemetry() {
+    TelemetryRecord record;
+    SDL_zero(record);
+
+    record.tick = tickCount;
+    record.timeNS = SDL_GetTicksNS();
+    record.score = score;
+    record.speed = speed;
+    record.linesCleared = board->getLinesCleared();
+    record.piecesSpawned = piecesSpawned;
+    record.width = static_cast<Uint8>(grid_Width);
+    record.height = static_cast<Uint8>(grid_Height);
+    record.pieceType = static_cast<Uint8>(piece->getType());
+    record.gameOver = gameOver ? 1 : 0;
+    record.pieceX = static_cast<Sint8>(piece->getPieceX());
+    record.pieceY = static_cast<Sint8>(piece->getPieceY());
+    const std::vector<std::pair<int, int>>& blocks = piece->getBlock();
+    for (int i = 0; i < static_cast<int>(blocks.size()) && i < 4; ++i) {
+        record.pieceBlocks[i][0] = static_cast<Sint8>(piece->getPieceX() + blocks[i].first);
+        record.pieceBlocks[i][1] = static_cast<Sint8>(piece->getPieceY() + blocks[i].second);
+    }
+
+    record.inputCount = static_cast<Uint8>(tickInputCount);
+    for (int i = 0; i < tickInputCount; ++i) {
+        record.inputs[i] = tickInputs[i];
+    }
+
+    // Board occupancy as one bitmask per row
+    for (int y = 0; y < grid_Height && y < TelemetryRecord::MAX_HEIGHT; ++y) {
+        Uint16 bits = 0;
+        for (int x = 0; x < grid_Width && x < 16; ++x) {
+            if (!board->isCellEmpty(x, y)) {
+                bits |= static_cast<Uint16>(1u << x);
+            }
+        }
+        record.occupancy[y] = bits;
+    }
+
+    telemetry->publish(record);
+}
+
+void Game::runSimulation() {
+    const Uint64 tickLength = SDL_NS_PER_SECOND / TICK_RATE;  // Duration of one tick in nanoseconds
+    Uint64 nextTick = SDL_GetTicksNS();
+
+    while (simRunning) {
+        simulationTick(SDL_GetTicks());
+
+        // Sleep until the next tick; if we fell behind, start counting again from now
+        nextTick += tickLength;
+        Uint64 now = SDL_GetTicksNS();
+        if (nextTick > now) {
+            SDL_DelayNS(nextTick - now);
+        } else {
+            nextTick = now;
+        }
+    }
+}
+
+void Game::showPerfectClearHint() {
+    AllocScope scope(AllocSubsystem::Solver);  // Asked for by the player: not part of the steady state
+
+    if (!solver) {
+        solver = new PerfectClearSolver();
+    }
+
+    std::vector<PieceType> queue;
+    for (int i = 0; i < QUEUE_SIZE; ++i) {
+        queue.push_back(getNextPiece(i));
+    }
+
+    // The search starts at the lowest height that holds the whole stack and tries the higher ones after it
+    int stackHeight = board->getStackHeight();
+    int rows = stackHeight < PerfectClearSolver::MIN_ROWS ? PerfectClearSolver::MIN_ROWS : stackHeight;
+
+    hintBlocks.clear();
+    hintPiece = piecesSpawned;
+    if (rows > PerfectClearSolver::MAX_ROWS) {
+        SDL_Log("Perfect clear hint: the stack is higher than %d rows", PerfectClearSolver::MAX_ROWS);
+        return;
+    }
+
+    // The solver works on copies on its own thread; the result is picked up by a later tick
+    if (solver->startSearch(*board, *piece, queue, rows, HINT_BUDGET_MS, 1)) {
+        hintRequestPiece = piecesSpawned;
+    } else {
+        SDL_Log("Perfect clear hint: the previous search is still running");
+    }
+}
+
+void Game::collectPerfectClearHint() {
+    if (!solver) {
+        return;
+    }
+    AllocScope scope(AllocSubsystem::Solver);
+    PerfectClearResult result;
+    int rows;
+    if (!solver->takeResult(result, rows)) {
+        return;
+    }
+
+    // The hint is only shown if it is still for the active piece
+    if (hintRequestPiece == piecesSpawned && !result.solutions.empty()) {
+        const PerfectClearPlacement& first = result.solutions[0][0];
+        hintBlocks.clear();
+        for (int k = 0; k < 4; ++k) {
+            hintBlocks.push_back({first.blocks[k][0], first.blocks[k][1]});
         }
+        hintPiece = piecesSpawned;
+        stateChanged = true;
     }
+    hintRequestPiece = -1;
+    SDL_Log("Perfect clear hint (%d rows, %d threads): %llu solutions, %llu fields in %.1f ms (%.0f solutions/s)%s",
+            rows, solver->threadCount(), static_cast<unsigned long long>(result.solutionCount),
+            static_cast<unsigned long long>(result.nodes), result.wallTimeMs, result.solutionsPerSecond,
+            result.complete ? "" : ", time budget reached");
+}
+
+void Game::publishFrame() {
+    fillSnapshot(frames.writeBuffer());
+    frames.publish();
+}
+
+void Game::fillSnapshot(FrameSnapshot& frame) const {
+    // Copy the board cells (the vector keeps its capacity, so this does not reallocate after the first frames)
+    frame.width = grid_Width;
+    frame.height = grid_Height;
+    frame.cells.resize(grid_Width * grid_Height);
+    for (int y = 0; y < grid_Height; ++y) {
+        for (int x = 0; x < grid_Width; ++x) {
+            frame.cells[y * grid_Width + x] = board->getCell(x, y);
+        }
+    }
+
+    // Copy the active piece in board coordinates
+    frame.pieceBlocks.clear();
+    for (const auto& block : piece->getBlock()) {
+        frame.pieceBlocks.push_back({piece->getPieceX() + block.first, piece->getPieceY() + block.second});
+    }
+    frame.pieceColor = piece->getColor();
+
+    // The hint only holds for the piece it was computed for
+    frame.hintBlocks.clear();
+    if (hintPiece == piecesSpawned) {
+        frame.hintBlocks = hintBlocks;
+    }
+
+    frame.score = score;
+    frame.gameOver = gameOver;
 }
 
 void Game::update() {
@@ -146,41 +616,83 @@ void Game::update() {
             int y = piece->getPieceY() + block.second;
             board->setCell(x, y, piece->getColor());  // Set the color of the block on the board
         }
-        audio->playSound("pieceLanded");  // Play sound when piece lands
+        playSound(SoundId::PieceLanded);  // Play sound when piece lands
+        int scoreBefore = score;
+        int pieceSpeed = speed;  // Speed the piece fell at, before the update below
         updateSpeed();  // Update the speed based on the score
         
-        board->clearFullLines();  // Clear any full lines on the board
+        int lines = board->clearFullLines();  // Clear any full lines on the board
+        if (pieceStats) {
+            recordPiece(lines, score - scoreBefore, pieceSpeed);
+        }
+
+        // Versus mode: lines cleared first cancel incoming garbage, the rest is sent to the opponent
+        int attack = lines == 4 ? 4 : (lines >= 2 ? lines - 1 : 0);
+        int cancelled = attack < garbageReceived ? attack : garbageReceived;
+        garbageReceived -= cancelled;
+        garbageSent += attack - cancelled;
+
+        // Garbage still waiting rises from the bottom now, all with the same hole
+        if (garbageReceived > 0) {
+            garbageRng ^= garbageRng << 13;
+            garbageRng ^= garbageRng >> 17;
+            garbageRng ^= garbageRng << 5;
+            if (!board->insertGarbageLines(garbageReceived, static_cast<int>(garbageRng % grid_Width))) {
+                gameOver = true;  // Filled cells were pushed out of the top
+            }
+            garbageReceived = 0;
+        }
 
         spawnPiece();  // Spawn a new piece
     }
 }
 
-void Game::render(SDL_Renderer* renderer) {
-    board->draw(renderer);  // Draw the game board
+void Game::render(SDL_Renderer* renderer, const FrameSnapshot& frame) {
+    // Draw the game board (already filled in by the animation when the game is over)
+    for (int y = 0; y < frame.height; ++y) {
+        for (int x = 0; x < frame.width; ++x) {
+            Board::drawCell(renderer, x, y, frame.cells[y * frame.width + x]);
+        }
+    }
+
+    if (!frame.gameOver) {
+        // Outline where the hint puts the current piece
+        SDL_SetRenderDrawColor(renderer, 255, 255, 255, 255);
+        for (const auto& block : frame.hintBlocks) {
+            SDL_FRect rect = {static_cast<float>(block.first * Board::CELL_SIZE + 2), static_cast<float>(block.second * Board::CELL_SIZE + 2),
+                              static_cast<float>(Board::CELL_SIZE - 4), static_cast<float>(Board::CELL_SIZE - 4)};
+            SDL_RenderRect(renderer, &rect);
+        }
 
-    if (gameOver) {
-        fillGridAnimation(renderer);  // Fill the grid with animation if the game is over
-    } else {
-        piece->draw(renderer);  // Draw the current piece
+        // Draw the current piece
+        for (const auto& block : frame.pieceBlocks) {
+            Piece::drawBlock(renderer, block.first, block.second, frame.pieceColor);
+        }
     }
 
     // Display score on the screen
-    displayText(renderer, "Score:", scoreX, scoreY, {255, 255, 255, 255}, 24);
-    displayText(renderer, std::to_string(score), scoreX + 80, scoreY, {255, 255, 255, 255}, 24);
+    displayText(renderer, SCORE_TEXT, scoreX, scoreY, {255, 255, 255, 255}, 24);
+    displayNumber(renderer, frame.score, scoreX + 80, scoreY, {255, 255, 255, 255}, 24);
+
+    // If the game is over, display "Game Over" and the restart message
+    if (frame.gameOver) {
+        displayText(renderer, GAME_OVER_TEXT, scoreX, scoreY + 40, {255, 0, 0, 255}, 48);
+        displayText(renderer, RESTART_TEXT, scoreX, scoreY + 120, {255, 255, 255, 255}, 24);
+    }
 }
 
 void Game::spawnPiece() {
-    // Delete old piece and create a new one
+    // Take the next piece from the queue and refill it with a new random piece.
+    // The piece object is reused: only its type, position and rotation change
     if (piece) {
-        delete piece;
-        piece = nullptr;
+        piece->reset(4, 0, nextPieces[queueHead]);
+    } else {
+        piece = new Piece(this, board, 4, 0, nextPieces[queueHead]);
     }
-    
-    // Create a new random piece
-    PieceType types[] = {PieceType::I, PieceType::O, PieceType::T, PieceType::L, 
-                         PieceType::J, PieceType::S, PieceType::Z};
-    PieceType randomType = types[std::rand() % 7];
-    piece = new Piece(this, board, 4, 0, randomType);
+    nextPieces[queueHead] = randomPieceType();
+    queueHead = (queueHead + 1) % QUEUE_SIZE;
+    piecesSpawned++;
+    pieceSpawnTime = tickTime;
 
     // If the piece cannot spawn due to collision, game is over
     if (checkCollision(0, 0)) {  
@@ -204,29 +716,39 @@ bool Game::checkCollision(int dx, int dy) {
 }
 
 void Game::resetGame() {
-    // Delete old piece and board, and create new ones
-    if (piece) {
-        delete piece;
-        piece = nullptr;
-    }
-    
-    if (board) {
-        delete board;
-    }
-
-    board = new Board(this, piece, audio, grid_Width, grid_Height);  // Create new board
+    // Empty the board and spawn a new piece (both objects are reused)
+    board->clear();
     spawnPiece();  // Spawn a new piece
     
     // Reset game state
     score = 0;
     speed = 500;
     gameOver = false;
-    run = true;
     once = false;
     fillProgress = 0;
     isFilling = false;
+    fillStartTime = 0;
+    piecesSpawned = 1;
+    garbageSent = 0;
+    garbageReceived = 0;
+    hintBlocks.clear();  // A hint from the previous game would match the new first piece
+    hintRequestPiece = -1;  // So would the result of a search still running
+    if (pieceStats) {
+        pieceStats->startGame();  // The pieces of the new game are numbered from 1 again
+    }
+
+    playMusic();  // Play background music
+}
 
-    audio->playMusic("background", -1);  // Play background music
+void Game::resetGame(Uint32 seed) {
+    // Restart the piece sequence exactly as a new Game(seed) would start it
+    rngState = seed ? seed : 1;
+    garbageRng = rngState ^ 0x9e3779b9u;
+    queueHead = 0;
+    for (int i = 0; i < QUEUE_SIZE; ++i) {
+        nextPieces[i] = randomPieceType();
+    }
+    resetGame();
 }
 
 void Game::displayErrorMessage(const std::string& message) {
@@ -239,43 +761,155 @@ void Game::displayErrorMessage(const std::string& message) {
     );
 }
 
-void Game::displayText(SDL_Renderer* renderer, std::string t, float x, float y, SDL_Color c, int fontSize) {
-    SDL_Color color = c;
-    TTF_Font* font = TTF_OpenFont("arial.ttf", fontSize);  // Load font
-    std::string text = t;
-    SDL_Surface* surface = TTF_RenderText_Solid(font, text.c_str(), text.size(), color);  // Render text to surface
-    
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);  // Create texture from surface
-    
-    // Set the destination rectangle for the text
-    SDL_FRect dest = {x, y, static_cast<float>(surface->w), static_cast<float>(surface->h)};
-    SDL_RenderTexture(renderer, texture, NULL, &dest);  // Render the text
-    
+const Game::CachedText* Game::cachedText(SDL_Renderer* renderer, const char* text, SDL_Color color, int fontSize) {
+    // Already rendered with this font size and color?
+    for (const CachedText& entry : textCache) {
+        if (entry.fontSize == fontSize && entry.color.r == color.r && entry.color.g == color.g &&
+            entry.color.b == color.b && entry.color.a == color.a && entry.text == text) {
+            return &entry;
+        }
+    }
+
+    // Open the font once per size
+    TTF_Font* font = nullptr;
+    for (const auto& entry : fonts) {
+        if (entry.first == fontSize) {
+            font = entry.second;
+        }
+    }
+    if (!font) {
+        font = TTF_OpenFont("arial.ttf", fontSize);  // Load font
+        if (!font) {
+            return nullptr;
+        }
+        fonts.push_back({fontSize, font});
+    }
+
+    SDL_Surface* surface = TTF_RenderText_Solid(font, text, 0, color);  // Render text to surface
+    if (!surface) {
+        return nullptr;
+    }
+    CachedText entry;
+    entry.text = text;
+    entry.fontSize = fontSize;
+    entry.color = color;
+    entry.texture = SDL_CreateTextureFromSurface(renderer, surface);  // Create texture from surface
+    entry.w = static_cast<float>(surface->w);
+    entry.h = static_cast<float>(surface->h);
     SDL_DestroySurface(surface);  // Clean up surface
-    SDL_DestroyTexture(texture);  // Clean up texture
-    TTF_CloseFont(font);  // Close the font
+    textCache.push_back(entry);
+    return &textCache.back();
 }
 
-void Game::fillGridAnimation(SDL_Renderer* renderer) {
+void Game::displayText(SDL_Renderer* renderer, const char* text, float x, float y, SDL_Color color, int fontSize) {
+    AllocScope scope(AllocSubsystem::Text);
+    const CachedText* cached = cachedText(renderer, text, color, fontSize);
+    if (cached) {
+        // Set the destination rectangle for the text
+        SDL_FRect dest = {x, y, cached->w, cached->h};
+        SDL_RenderTexture(renderer, cached->texture, NULL, &dest);  // Render the text
+    }
+}
+
+void Game::displayNumber(SDL_Renderer* renderer, int value, float x, float y, SDL_Color color, int fontSize) {
+    AllocScope scope(AllocSubsystem::Text);
+    char digits[16];
+    SDL_snprintf(digits, sizeof(digits), "%d", value);
+    for (const char* c = digits; *c; ++c) {
+        char glyph[2] = {*c, 0};
+        const CachedText* cached = cachedText(renderer, glyph, color, fontSize);
+        if (cached) {
+            SDL_FRect dest = {x, y, cached->w, cached->h};
+            SDL_RenderTexture(renderer, cached->texture, NULL, &dest);
+            x += cached->w;  // Next digit to the right
+        }
+    }
+}
+
+void Game::prepareText(SDL_Renderer* renderer) {
+    AllocScope scope(AllocSubsystem::Text);
+    cachedText(renderer, SCORE_TEXT, {255, 255, 255, 255}, 24);
+    cachedText(renderer, GAME_OVER_TEXT, {255, 0, 0, 255}, 48);
+    cachedText(renderer, RESTART_TEXT, {255, 255, 255, 255}, 24);
+    for (char digit = '0'; digit <= '9'; ++digit) {
+        char glyph[2] = {digit, 0};
+        cachedText(renderer, glyph, {255, 255, 255, 255}, 24);
+    }
+}
+
+void Game::clearTextCache() {
+    for (const CachedText& entry : textCache) {
+        SDL_DestroyTexture(entry.texture);  // Clean up texture
+    }
+    textCache.clear();
+    for (const auto& entry : fonts) {
+        TTF_CloseFont(entry.second);  // Close the font
+    }
+    fonts.clear();
+}
+
+bool Game::fillGridAnimation(Uint64 now) {
     // Animate filling the grid with color when the game is over
-    if (!isFilling) {
+    int totalCells = grid_Width * grid_Height;
+    if (!isFilling && fillProgress == 0) {
         isFilling = true;
-        fillProgress = 0;
+        fillStartTime = now;
     }
 
-    if (fillProgress < grid_Width * grid_Height) {
+    // Fill every cell that is due according to the elapsed time
+    int target = static_cast<int>((now - fillStartTime) * FILL_CELLS_PER_SECOND / 1000);
+    if (target > totalCells) target = totalCells;
+
+    SDL_Color gray = {128, 128, 128, 255};
+    while (fillProgress < target) {
         int x = fillProgress % grid_Width;
         int y = grid_Height - 1 - (fillProgress / grid_Width);
-
-        SDL_Color gray = {128, 128, 128, 255};
         board->setCell(x, y, gray);  // Set gray color for the cell
-
-        board->draw(renderer);  // Draw the updated grid
-
         fillProgress++;  // Increment the fill progress
-    } else {
+    }
+
+    if (fillProgress >= totalCells) {
         isFilling = false;  // End the filling animation
     }
+    return isFilling;
+}
+
+void Game::initAudio() {
+    if (audio) {
+        audio->init();  // Open the audio device
+        audio->loadAllSounds();  // Load all sound effects and music
+    }
+}
+
+void Game::playMusic() {
+    if (audio) {
+        audio->playMusic(MusicId::Background, -1);  // Loop the background music
+    }
+}
+
+void Game::playSound(SoundId id) {
+    if (audio) {
+        AllocScope scope(AllocSubsystem::Audio);
+        audio->playSound(id);
+    }
+}
+
+void Game::stopMusic() {
+    if (audio) {
+        audio->stopMusic();
+    }
+}
+
+PieceType Game::randomPieceType() {
+    // Define the different types of Tetris pieces
+    static const PieceType types[] = {PieceType::I, PieceType::O, PieceType::T, PieceType::L, 
+                                      PieceType::J, PieceType::S, PieceType::Z};
+
+    // xorshift32: cheap, and the sequence only depends on the seed
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return types[rngState % 7];
 }
 
 void Game::updateSpeed() {
@@ -12,10 +12,35 @@
 #include <cstdlib>    // Include for random number generation
 #include <ctime>      // Include for time-based functions
 #include <string>     // Include for string manipulation
+#include <atomic>     // Include for the flags shared between the render and simulation threads
+
+#include "triple_buffer.h"  // Lock-free hand-off of frame snapshots to the render thread
+#include "spsc_queue.h"     // Lock-free hand-off of player input to the simulation thread
 
 class Board;            // Forward declaration of Board class
 class Piece;            // Forward declaration of Piece class
 class AudioManager;     // Forward declaration of AudioManager class
+class TelemetryWriter;  // Forward declaration of TelemetryWriter class
+class FrameCapture;     // Forward declaration of FrameCapture class
+class PerfectClearSolver;  // Forward declaration of PerfectClearSolver class
+class PieceStatsWriter;    // Forward declaration of PieceStatsWriter class
+struct GameState;          // Forward declaration of GameState structure
+enum class PieceType;   // Forward declaration of PieceType (defined in piece.h)
+enum class SoundId;     // Forward declaration of SoundId (defined in audio_manager.h)
+
+// Player actions sent from the render thread to the simulation thread
+enum class InputAction { MoveLeft, MoveRight, MoveDown, Rotate, Reset, Hint };
+
+// Immutable copy of everything the render thread needs to draw one frame
+struct FrameSnapshot {
+    int width = 0, height = 0;                         // Dimensions of the board
+    std::vector<SDL_Color> cells;                      // Board cells, row by row
+    std::vector<std::pair<int, int>> pieceBlocks;      // Board coordinates of the active piece's blocks
+    SDL_Color pieceColor = {0, 0, 0, 0};               // Color of the active piece
+    std::vector<std::pair<int, int>> hintBlocks;       // Where the perfect clear hint puts the active piece (empty if none)
+    int score = 0;                                     // Score at the time of the snapshot
+    bool gameOver = false;                             // True once the game is over
+};
 
 // Game class encapsulates the main logic of the Tetris-like game
 class Game {
@@ -23,20 +48,73 @@ public:
     // Constructor: Initializes the game state, pieces, board, audio, etc.
     Game();
     
+    // Constructor for a game driven by code (AI, tools): pieces follow the given seed.
+    // Without audio the game never touches SDL's audio or video subsystems
+    explicit Game(Uint32 seed, bool withAudio = false);
+    
     // Destructor: Cleans up dynamically allocated resources
     ~Game();
 
-    // Starts the game loop and initializes SDL components
+    // Starts the render loop on the calling thread and the simulation on its own thread
     void start();
     
     // Handles user input events (key presses, window events)
     void handleEvents();
     
+    // Handles a single event; returns false when the remaining queued events should be skipped
+    bool processEvent(const SDL_Event& event);
+    
     // Updates the game state (moves the piece, checks for collisions)
     void update();
     
-    // Renders the game board, pieces, and other game elements
-    void render(SDL_Renderer* renderer);
+    // Applies one player action to the game state (simulation thread)
+    void applyInput(InputAction action);
+    
+    // Runs one fixed simulation tick: input, gravity, game over animation (simulation thread)
+    void simulationTick(Uint64 now);
+    
+    // Moves the piece down if 'speed' milliseconds have passed since the last gravity step at time 'now' (ms)
+    void applyGravity(Uint64 now);
+    
+    // Copies everything the simulation depends on, or puts it back (versus mode rollback)
+    void saveState(GameState& state) const;
+    void loadState(const GameState& state);
+    
+    // Versus mode: clearing 2, 3 or 4 lines sends 1, 2 or 4 garbage lines to the opponent. Lines received
+    // first cancel the lines the game would send, and the rest rise from the bottom when the next piece locks
+    int takeGarbageSent();
+    void receiveGarbage(int lines);
+    
+    // Simulation thread loop: ticks at TICK_RATE until stopped
+    void runSimulation();
+    
+    // Starts a search for a perfect clear with the active piece and the queue on the solver's thread
+    void showPerfectClearHint();
+
+    // Shows where the active piece goes once that search has finished (checked every tick, never waits)
+    void collectPerfectClearHint();
+    
+    // Copies the current game state into the triple buffer for the render thread
+    void publishFrame();
+    
+    // Copies the current game state into a snapshot (reusing its storage)
+    void fillSnapshot(FrameSnapshot& frame) const;
+    
+    // Publishes every simulation tick into the named shared memory ring; returns false on failure
+    bool enableTelemetry(const std::string& name);
+    
+    // Writes the state of the current tick to the telemetry ring (simulation thread)
+    void publishTelemetry();
+    
+    // Records the metrics of every placed piece to a statistics file (not owned; null stops recording).
+    // Each game played from now on gets its own game number in the file
+    void setPieceStats(PieceStatsWriter* writer);
+    
+    // Records every presented frame to the given Y4M file once the game starts
+    void setCapturePath(const std::string& path) { capturePath = path; }
+    
+    // Renders the game board, pieces, and other game elements from a snapshot
+    void render(SDL_Renderer* renderer, const FrameSnapshot& frame);
     
     // Spawns a new piece at the top of the board
     void spawnPiece();
@@ -47,35 +125,65 @@ public:
     // Displays an error message box with the specified text
     void displayErrorMessage(const std::string& message);
     
-    // Renders text (score, messages) on the screen at the given position
-    void displayText(SDL_Renderer* renderer, std::string text, float x, float y, SDL_Color color, int fontSize);
+    // Renders text (score, messages) on the screen at the given position.
+    // Each text is rendered to a texture the first time it is shown and drawn from that texture afterwards
+    void displayText(SDL_Renderer* renderer, const char* text, float x, float y, SDL_Color color, int fontSize);
+    
+    // Renders a number digit by digit, so a changing score reuses the same ten cached digits
+    void displayNumber(SDL_Renderer* renderer, int value, float x, float y, SDL_Color color, int fontSize);
+    
+    // Renders every text the game shows (labels and the ten digits) into the cache, so drawing never has to
+    void prepareText(SDL_Renderer* renderer);
+    
+    // Releases the cached text textures and fonts (before the renderer and SDL_ttf are shut down)
+    void clearTextCache();
     
     // Resets the game to its initial state
     void resetGame();
     
+    // Resets the game and restarts the piece sequence from the given seed
+    void resetGame(Uint32 seed);
+    
     // Initializes the audio components (music and sound effects)
     void initAudio();
     
-    // Plays the background music for the game
+    // Plays the background music for the game (no-op for games without audio)
     void playMusic();
     
-    // Plays the given sound effect (move, rotate, etc.)
-    void playSound(Mix_Chunk* sound);
+    // Plays the given sound effect (move, rotate, etc.) (no-op for games without audio)
+    void playSound(SoundId id);
     
-    // Stops the background music
+    // Stops the background music (no-op for games without audio)
     void stopMusic();
     
+    // Returns a random piece type drawn from this game's own generator
+    PieceType randomPieceType();
+    
+    // Number of upcoming pieces known in advance
+    static const int QUEUE_SIZE = 5;
+    
+    // Returns the i-th upcoming piece (0 is the next one to spawn)
+    PieceType getNextPiece(int i) const { return nextPieces[(queueHead + i) % QUEUE_SIZE]; }
+    
     // Updates the game speed based on the current score
     void updateSpeed();
     
-    // Animates the grid filling when the game is over (for game over screen)
-    void fillGridAnimation(SDL_Renderer* renderer);
+    // Advances the grid filling animation when the game is over (for game over screen).
+    // Runs on its own clock; returns true while cells are still being filled
+    bool fillGridAnimation(Uint64 now);
 
     // Getter for score
     int getScore() const { return score; }
 
     // Setter for score
     void setScore(int x) { score = x; }
+
+    // Getters used by code that drives or observes the game without the render loop
+    Board* getBoard() const { return board; }
+    Piece* getPiece() const { return piece; }
+    bool isGameOver() const { return gameOver; }
+    int getSpeed() const { return speed; }
+    int getPiecesSpawned() const { return piecesSpawned; }
     
 private:
     // Pointers to the game board and current piece
@@ -87,11 +195,68 @@ private:
     
     // Game state variables
     bool gameOver;  // Flag indicating if the game is over
-    bool run;       // Flag for the game loop
+    bool run;       // Flag for the render loop (render thread)
+    bool redraw;    // Set when the current frame must be drawn again: first frame, window exposed (render thread)
+
+    // Simulation thread and the lock-free channels shared with it
+    static const int TICK_RATE = 60;              // Simulation ticks per second
+    std::atomic<bool> simRunning;                 // Cleared by the render thread to stop the simulation
+    std::atomic<bool> renderIdle;                 // Set while the render thread waits for events
+    Uint32 wakeEvent;                             // Event type pushed to wake an idle render thread
+    SpscQueue<InputAction, 64> inputQueue;        // Render thread -> simulation thread
+    TripleBuffer<FrameSnapshot> frames;           // Simulation thread -> render thread
+    bool stateChanged;                            // Set when the state differs from the last published frame
+    Uint64 lastGravityTime;                       // Time (ms) of the last gravity step
+    Uint64 tickCount;                             // Number of simulation ticks run
+
+    // Telemetry published to shared memory (optional)
+    TelemetryWriter* telemetry;                   // Null unless enableTelemetry() succeeded
+    static const int MAX_TICK_INPUTS = 15;        // Inputs recorded per tick (matches TelemetryRecord::MAX_INPUTS)
+    Uint8 tickInputs[MAX_TICK_INPUTS];            // Inputs applied during the current tick
+    int tickInputCount;                           // Number of entries in tickInputs
+
+    // Per-piece statistics (optional, simulation thread)
+    PieceStatsWriter* pieceStats;                 // Null unless setPieceStats() was given a writer
+    Uint64 tickTime;                              // Time (ms) of the current simulation tick
+    Uint64 pieceSpawnTime;                        // Time (ms) of the tick the active piece spawned in
+
+    // Appends the record of the piece that just locked
+    void recordPiece(int lines, int scoreDelta, int pieceSpeed);
+
+    // Perfect clear hint (simulation thread)
+    static const int HINT_BUDGET_MS = 30;         // Time the solver may take when the hint is asked for (on its own thread)
+    PerfectClearSolver* solver;                   // Created the first time a hint is asked for
+    std::vector<std::pair<int, int>> hintBlocks;  // Blocks of the hinted placement
+    int hintPiece;                                // Spawn number of the piece the hint is for
+    int hintRequestPiece;                         // Spawn number of the piece the running search is for (-1 if none)
+
+    // Video capture of the presented frames (optional, render thread)
+    std::string capturePath;                      // Output file, empty when capture is disabled
+
+    // Text rendered once and kept as a texture (render thread)
+    struct CachedText {
+        std::string text;                         // Text as passed to displayText
+        int fontSize;                             // Font size it was rendered with
+        SDL_Color color;                          // Color it was rendered with
+        SDL_Texture* texture;                     // Rendered text
+        float w, h;                               // Size of the texture
+    };
+    std::vector<CachedText> textCache;            // Every text shown so far
+    std::vector<std::pair<int, TTF_Font*>> fonts; // Fonts opened so far, by size
+
+    // Returns the cached texture of a text, rendering it on first use (null if it cannot be rendered)
+    const CachedText* cachedText(SDL_Renderer* renderer, const char* text, SDL_Color color, int fontSize);
 
     // Game-specific variables
     int score;      // Current score
     int speed;      // Current game speed (affects how fast pieces fall)
+    int piecesSpawned;  // Number of pieces spawned since the last reset
+    Uint32 rngState;    // State of the piece generator (xorshift), so games can be replayed from a seed
+    int garbageSent;      // Versus mode: garbage lines sent and not yet taken by takeGarbageSent()
+    int garbageReceived;  // Versus mode: garbage lines waiting to be inserted
+    Uint32 garbageRng;    // Generator of the garbage holes (separate, so garbage does not change the pieces)
+    PieceType nextPieces[QUEUE_SIZE];  // Upcoming pieces (ring buffer)
+    int queueHead;      // Index of the next piece in nextPieces
     
     // Window dimensions and grid size
     int win_Width = 800;
@@ -104,8 +269,10 @@ private:
     float scoreY = 20;
 
     // Animation-related variables for the game-over screen
+    static const int FILL_CELLS_PER_SECOND = 120;  // Speed of the grid-filling animation
     int fillProgress;  // Progress of the grid-filling animation
     bool isFilling;    // Flag for the grid-filling animation
+    Uint64 fillStartTime;  // Time (ms) at which the grid-filling animation started
     bool once;         // Flag to ensure the game over sound plays only once
 };
 
@@ -0,0 +1,38 @@
+// game_state.h
+
+#ifndef GAME_STATE_H
+#define GAME_STATE_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the fixed-size integer types
+
+#include "game.h"       // Includes the Game class (queue size)
+#include "board.h"      // Includes the Board class, copied whole
+#include "piece.h"      // Includes the PieceType enum
+
+// Everything the simulation of a game depends on, so a game can be saved and put back exactly as it was
+// (rollback in versus mode) and two copies of a game can be compared. Saving into the same GameState
+// again reuses its storage, so it does not allocate once the board has been copied a first time
+struct GameState {
+    GameState() : board(nullptr, nullptr, nullptr) {}
+
+    Board board;                               // Cells, row ring and line counter
+    int pieceX, pieceY;                        // Position of the active piece
+    PieceType pieceType;                       // Type of the active piece
+    int pieceRotation;                         // Rotation of the active piece
+    int score;                                 // Score
+    int speed;                                 // Gravity delay (ms)
+    int piecesSpawned;                         // Pieces spawned since the last reset
+    Uint32 rngState;                           // Piece generator
+    PieceType nextPieces[Game::QUEUE_SIZE];    // Upcoming pieces (ring buffer)
+    int queueHead;                             // Index of the next piece in nextPieces
+    bool gameOver;                             // True once the game is over
+    Uint64 lastGravityTime;                    // Time (ms) of the last gravity step
+    int garbageSent;                           // Garbage lines sent and not yet handed to the opponent
+    int garbageReceived;                       // Garbage lines waiting to be inserted
+    Uint32 garbageRng;                         // Generator of the garbage holes
+
+    // Checksum of the state (FNV-1a): two games that were given the same inputs have the same checksum
+    Uint32 checksum() const;
+};
+
+#endif
@@ -1,17 +1,93 @@
 // main.cpp
 
+#include <string>   // Include for parsing the command line
+#include <cstdlib>  // Include for std::atoi
+
 #include "game.h"   // Includes the Game class, which manages the game logic
 #include "board.h"  // Includes the Board class, which represents the game board
 #include "piece.h"  // Includes the Piece class, which represents the game pieces
+#include "spectator_view.h"  // Includes the SpectatorView class, which shows many AI games at once
+#include "alloc_tracker.h"  // Includes the allocation counters (opt-in)
+#include "piece_stats.h"  // Includes the per-piece statistics file writer
+#include "versus_view.h"  // Includes the VersusView class, which plays against a peer over UDP
+
+// Returns the value following option i if there is one, otherwise the given default
+static std::string optionValue(int argc, char* argv[], int& i, const char* defaultValue) {
+    if (i + 1 < argc && argv[i + 1][0] != '-') {
+        return argv[++i];
+    }
+    return defaultValue;
+}
+
+int main(int argc, char* argv[]) {
+    AllocTracker::install();  // Counts SDL's allocations too when built with TETRIS_TRACK_ALLOCATIONS
+
+    std::string telemetryName;  // Shared memory name for telemetry, empty when disabled
+    std::string capturePath;    // Video file to record, empty when disabled
+    std::string statsPath;      // Per-piece statistics file, empty when disabled
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--spectate") {
+            // "--spectate [boards]" shows AI-driven boards instead of starting a game
+            SpectatorView view(std::atoi(optionValue(argc, argv, i, "100").c_str()));
+            view.start();
+            return 0;
+        } else if (arg == "--versus") {
+            // "--versus <local port> <peer ip:port> <player 1|2> [seed]" plays against another instance over UDP
+            if (i + 3 >= argc) {
+                SDL_Log("Usage: %s --versus <local port> <peer ip:port> <player 1|2> [seed]", argv[0]);
+                return 1;
+            }
+            int localPort = std::atoi(argv[i + 1]);
+            std::string peer = argv[i + 2];
+            int player = std::atoi(argv[i + 3]) == 2 ? 1 : 0;
+            i += 3;
+            Uint32 seed = static_cast<Uint32>(std::atoi(optionValue(argc, argv, i, "1").c_str()));
+            size_t colon = peer.rfind(':');
+            VersusView view(player, seed);
+            if (colon == std::string::npos || !view.start(localPort, peer.substr(0, colon).c_str(), std::atoi(peer.c_str() + colon + 1))) {
+                SDL_Log("Could not connect to the peer %s from port %d", peer.c_str(), localPort);
+                return 1;
+            }
+            return 0;
+        } else if (arg == "--telemetry") {
+            // "--telemetry [name]" publishes every simulation tick to shared memory
+            telemetryName = optionValue(argc, argv, i, "tetris_telemetry");
+        } else if (arg == "--capture") {
+            // "--capture [file]" records the game to a raw Y4M video
+            capturePath = optionValue(argc, argv, i, "capture.y4m");
+        } else if (arg == "--stats") {
+            // "--stats [file]" appends the metrics of every placed piece to a statistics file
+            statsPath = optionValue(argc, argv, i, "piece_stats.pst");
+        }
+    }
+
+    // The statistics writer outlives the game, so the file is closed (and indexed) after the last piece
+    PieceStatsWriter stats;
 
-int main() {
     // Create a Game object
     Game game;
     
+    if (!telemetryName.empty() && !game.enableTelemetry(telemetryName)) {
+        game.displayErrorMessage("Could not create the telemetry shared memory: " + telemetryName);
+    }
+    game.setCapturePath(capturePath);
+    if (!statsPath.empty()) {
+        if (stats.open(statsPath)) {
+            game.setPieceStats(&stats);
+        } else {
+            game.displayErrorMessage("Could not open the statistics file: " + statsPath);
+        }
+    }
+    
     // Start the game loop
     game.start();
 
+    if (!stats.close()) {
+        SDL_Log("Could not finish writing the statistics file %s; its index will be rebuilt when it is read", statsPath.c_str());
+    }
+
     // Return 0 to indicate successful execution
     return 0;
 }
-
@@ -0,0 +1,450 @@
+// perfect_clear.cpp
+
+#include "perfect_clear.h"  // Includes the PerfectClearSolver class
+#include "board.h"          // Includes the Board class which represents the game grid
+#include "piece.h"          // Includes the Piece class which represents the Tetris pieces
+
+#include <unordered_set>    // Include unordered_set for the fields known to lead nowhere
+
+static const int FIELD_WIDTH = 10;                          // Cells per field row (one bit each)
+static const Uint64 FULL_ROW = (1ULL << FIELD_WIDTH) - 1;  // Bits of one complete row
+static const int SPLIT_DEPTH = 2;                           // Placements expanded up front to make the tasks
+static const int TIME_CHECK_INTERVAL = 1024;                // Fields visited between two looks at the clock
+
+// Search state owned by one thread: nothing in it is shared, so the workers never synchronize while searching
+struct PerfectClearSolver::Worker {
+    PerfectClearSolver* solver;                                 // Solver the thread works for
+    std::vector<PerfectClearPlacement> path;                    // Placements leading to the current field
+    std::vector<std::unordered_set<Uint64>> dead;               // Per depth: fields (with their ceiling) without a solution
+    std::vector<std::vector<PerfectClearPlacement>> solutions;  // Sequences kept by this thread
+    Uint64 solutionCount;                                       // Sequences found by this thread
+    Uint64 nodes;                                               // Fields visited by this thread
+};
+
+// Number of set bits (filled cells) in a field
+static int countCells(Uint64 field) {
+    int count = 0;
+    while (field) {
+        field &= field - 1;
+        count++;
+    }
+    return count;
+}
+
+// Constructor: starts the pool threads and the search thread, which wait until a search is started
+PerfectClearSolver::PerfectClearSolver(int threads) : quit(false), nextTask(0), timedOut(false), deadline(0), maxSolutions(0), boardWidth(0), boardHeight(0) {
+    if (threads <= 0) {
+        threads = SDL_GetNumLogicalCPUCores();
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    startWork = SDL_CreateSemaphore(0);
+    workDone = SDL_CreateSemaphore(0);
+    for (int i = 0; i < threads; ++i) {
+        Worker* worker = new Worker();
+        worker->solver = this;
+        states.push_back(worker);
+    }
+    for (int i = 0; i < threads - 1; ++i) {
+        workers.push_back(SDL_CreateThread(workerThread, "pc-solver", states[i]));
+    }
+
+    searchState = SEARCH_IDLE;
+    searchQuit = false;
+    searchBoard = new Board(nullptr, nullptr, nullptr);
+    searchPiece = new Piece(nullptr, nullptr, 0, 0, PieceType::I);
+    searchMinRows = MIN_ROWS;
+    searchBudgetMs = 0;
+    searchMaxKept = 1;
+    searchRows = 0;
+    searchStart = SDL_CreateSemaphore(0);
+    searcher = SDL_CreateThread(searchThread, "pc-search", this);
+}
+
+// Destructor: stops the search thread, then wakes the pool threads with the quit flag set and waits for them
+PerfectClearSolver::~PerfectClearSolver() {
+    // The search thread first: a search in progress still needs the pool to finish
+    searchQuit = true;
+    SDL_SignalSemaphore(searchStart);
+    SDL_WaitThread(searcher, NULL);
+    SDL_DestroySemaphore(searchStart);
+    delete searchPiece;
+    delete searchBoard;
+
+    quit = true;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        SDL_SignalSemaphore(startWork);
+    }
+    for (SDL_Thread* thread : workers) {
+        SDL_WaitThread(thread, NULL);
+    }
+    for (Worker* worker : states) {
+        delete worker;
+    }
+    SDL_DestroySemaphore(startWork);
+    SDL_DestroySemaphore(workDone);
+}
+
+std::vector<PerfectClearSolver::Orientation> PerfectClearSolver::orientationsOf(const std::vector<std::vector<int>>& shape) {
+    std::vector<Orientation> result;
+    std::vector<std::vector<int>> current = shape;
+
+    for (int rotation = 0; rotation < 4; ++rotation) {
+        // Block (i, j) of a shape is at x + i, y + j on the board, so the shape is shape.size() cells wide
+        Orientation o;
+        o.width = static_cast<int>(current.size());
+        o.height = static_cast<int>(current[0].size());
+        o.rotations = rotation;
+        o.mask = 0;
+        int n = 0;
+        for (int i = 0; i < o.width; ++i) {
+            for (int j = 0; j < o.height; ++j) {
+                if (current[i][j] == 1 && n < 4) {
+                    o.mask |= 1ULL << ((o.height - 1 - j) * FIELD_WIDTH + i);
+                    o.cells[n][0] = i;
+                    o.cells[n][1] = j;
+                    n++;
+                }
+            }
+        }
+
+        // O, I, S and Z look the same after some rotations: only the first of identical ones is kept
+        bool seen = false;
+        for (const Orientation& other : result) {
+            seen = seen || (other.mask == o.mask && other.width == o.width);
+        }
+        if (!seen) {
+            result.push_back(o);
+        }
+        current = Piece::rotatedShape(current);
+    }
+    return result;
+}
+
+bool PerfectClearSolver::place(const Orientation& o, PieceType type, int x, Uint64& field, int& ceiling, PerfectClearPlacement& placement) const {
+    if (o.height > ceiling || x + o.width > FIELD_WIDTH) {
+        return false;
+    }
+
+    // Start with the top of the piece at the ceiling (the board is empty above it) and drop it
+    int base = ceiling - o.height;
+    Uint64 mask = o.mask << (base * FIELD_WIDTH + x);
+    if (mask & field) {
+        return false;  // The column is blocked before the piece reaches the field
+    }
+    while (base > 0 && !((mask >> FIELD_WIDTH) & field)) {
+        mask >>= FIELD_WIDTH;
+        base--;
+    }
+    field |= mask;
+
+    // Where the piece lands on the board: field row r is board row boardHeight - 1 - r
+    placement.type = type;
+    placement.rotations = o.rotations;
+    placement.x = x;
+    placement.y = boardHeight - base - o.height;
+    for (int k = 0; k < 4; ++k) {
+        placement.blocks[k][0] = placement.x + o.cells[k][0];
+        placement.blocks[k][1] = placement.y + o.cells[k][1];
+    }
+
+    // Remove the rows the piece completed; the rows above move down and there is one row less to fill
+    for (int r = base + o.height - 1; r >= base; --r) {
+        if (((field >> (r * FIELD_WIDTH)) & FULL_ROW) == FULL_ROW) {
+            Uint64 below = field & ((1ULL << (r * FIELD_WIDTH)) - 1);
+            Uint64 above = (field >> ((r + 1) * FIELD_WIDTH)) << (r * FIELD_WIDTH);
+            field = below | above;
+            ceiling--;
+        }
+    }
+    return true;
+}
+
+bool PerfectClearSolver::canFinish(Uint64 field, int ceiling, int piecesLeft) const {
+    // The clear ends when the bottom 'lines' rows are full: at least as many rows as the stack is high,
+    // and the empty cells of those rows must be filled exactly by the pieces left (four cells each)
+    int top = 0;
+    while (top < ceiling && (field >> (top * FIELD_WIDTH))) {
+        top++;
+    }
+    int filled = countCells(field);
+    for (int lines = top > 0 ? top : 1; lines <= ceiling; ++lines) {
+        int empty = lines * FIELD_WIDTH - filled;
+        if (empty > 0 && empty % 4 == 0 && empty / 4 <= piecesLeft) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfectClearSolver::addSolution(Worker& worker) {
+    worker.solutionCount++;
+    if (static_cast<int>(worker.solutions.size()) < maxSolutions) {
+        worker.solutions.push_back(worker.path);
+    }
+}
+
+bool PerfectClearSolver::search(Worker& worker, Uint64 field, int ceiling, int depth) {
+    // Give up once the time budget is spent (a partly searched field is not remembered as dead)
+    if (++worker.nodes % TIME_CHECK_INTERVAL == 0 && SDL_GetTicksNS() >= deadline) {
+        timedOut = true;
+    }
+    if (timedOut) {
+        return true;
+    }
+
+    int piecesLeft = static_cast<int>(sequence.size()) - depth;
+    Uint64 key = field | (static_cast<Uint64>(ceiling) << 60);  // Fields use at most 60 bits
+    if (piecesLeft == 0 || worker.dead[depth].count(key) || !canFinish(field, ceiling, piecesLeft)) {
+        return false;
+    }
+
+    bool found = false;
+    const SequencePiece& piece = sequence[depth];
+    for (const Orientation& o : piece.orientations) {
+        for (int x = 0; x + o.width <= FIELD_WIDTH; ++x) {
+            Uint64 next = field;
+            int nextCeiling = ceiling;
+            PerfectClearPlacement placement;
+            if (!place(o, piece.type, x, next, nextCeiling, placement)) {
+                continue;
+            }
+
+            worker.path.push_back(placement);
+            if (next == 0) {
+                addSolution(worker);  // The board is empty: perfect clear
+                found = true;
+            } else if (search(worker, next, nextCeiling, depth + 1)) {
+                found = true;
+            }
+            worker.path.pop_back();
+        }
+    }
+
+    if (!found) {
+        worker.dead[depth].insert(key);
+    }
+    return found;
+}
+
+void PerfectClearSolver::runTasks(Worker& worker) {
+    // Take tasks until none are left or time is up
+    for (;;) {
+        int index = nextTask.fetch_add(1);
+        if (index >= static_cast<int>(tasks.size()) || timedOut) {
+            break;
+        }
+        const Task& task = tasks[index];
+        worker.path = task.path;
+        search(worker, task.field, task.ceiling, task.depth);
+    }
+}
+
+int PerfectClearSolver::workerThread(void* data) {
+    Worker* worker = static_cast<Worker*>(data);
+    PerfectClearSolver* solver = worker->solver;
+    for (;;) {
+        SDL_WaitSemaphore(solver->startWork);
+        if (solver->quit) {
+            break;
+        }
+        solver->runTasks(*worker);
+        SDL_SignalSemaphore(solver->workDone);
+    }
+    return 0;
+}
+
+PerfectClearResult PerfectClearSolver::solve(Board* board, const Piece& active, const std::vector<PieceType>& queue,
+                                             int rows, Uint32 budgetMs, int maxKept) {
+    Uint64 startTime = SDL_GetTicksNS();
+    PerfectClearResult result;
+    result.complete = true;
+
+    rows = rows < MIN_ROWS ? MIN_ROWS : (rows > MAX_ROWS ? MAX_ROWS : rows);
+    boardWidth = board->getWidth();
+    boardHeight = board->getHeight();
+    if (boardWidth != FIELD_WIDTH || boardHeight < rows) {
+        return result;  // Only standard width boards fit the bit field
+    }
+
+    // Pack the bottom rows into the field; anything above them rules out a perfect clear within 'rows' rows
+    Uint64 field = 0;
+    for (int y = 0; y < boardHeight; ++y) {
+        for (int x = 0; x < boardWidth; ++x) {
+            if (!board->isCellEmpty(x, y)) {
+                int r = boardHeight - 1 - y;
+                if (r >= rows) {
+                    return result;
+                }
+                field |= 1ULL << (r * FIELD_WIDTH + x);
+            }
+        }
+    }
+
+    // The sequence to place: the active piece as it is turned now, then the queue in spawn orientation
+    sequence.clear();
+    SequencePiece first = {active.getType(), orientationsOf(active.getShape())};
+    sequence.push_back(first);
+    for (PieceType type : queue) {
+        SequencePiece next = {type, orientationsOf(Piece::pieceShapes[type])};
+        sequence.push_back(next);
+    }
+
+    // Reset the per-thread state (the sets keep their buckets from one search to the next)
+    maxSolutions = maxKept;
+    for (Worker* worker : states) {
+        worker->path.clear();
+        worker->solutions.clear();
+        worker->dead.resize(sequence.size());
+        for (auto& set : worker->dead) {
+            set.clear();
+        }
+        worker->solutionCount = 0;
+        worker->nodes = 0;
+    }
+
+    // Expand the first placements into tasks; clears found this early go straight to the caller's state
+    Worker& caller = *states.back();
+    tasks.clear();
+    std::vector<Task> frontier(1);
+    frontier[0].field = field;
+    frontier[0].ceiling = rows;
+    frontier[0].depth = 0;
+    for (int level = 0; level < SPLIT_DEPTH && level < static_cast<int>(sequence.size()); ++level) {
+        std::vector<Task> expanded;
+        for (const Task& task : frontier) {
+            if (!canFinish(task.field, task.ceiling, static_cast<int>(sequence.size()) - task.depth)) {
+                continue;
+            }
+            const SequencePiece& piece = sequence[task.depth];
+            for (const Orientation& o : piece.orientations) {
+                for (int x = 0; x + o.width <= FIELD_WIDTH; ++x) {
+                    Task next = task;
+                    PerfectClearPlacement placement;
+                    if (!place(o, piece.type, x, next.field, next.ceiling, placement)) {
+                        continue;
+                    }
+                    next.depth++;
+                    next.path.push_back(placement);
+                    if (next.field == 0) {
+                        caller.path = next.path;
+                        addSolution(caller);
+                    } else {
+                        expanded.push_back(next);
+                    }
+                }
+            }
+        }
+        frontier.swap(expanded);
+    }
+    tasks.swap(frontier);
+
+    // Search the tasks on every thread, the caller included
+    deadline = startTime + static_cast<Uint64>(budgetMs) * 1000000;
+    nextTask = 0;
+    timedOut = false;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        SDL_SignalSemaphore(startWork);
+    }
+    runTasks(caller);
+    for (size_t i = 0; i < workers.size(); ++i) {
+        SDL_WaitSemaphore(workDone);
+    }
+
+    // Merge what each thread found
+    for (Worker* worker : states) {
+        result.solutionCount += worker->solutionCount;
+        result.nodes += worker->nodes;
+        for (const auto& solution : worker->solutions) {
+            if (static_cast<int>(result.solutions.size()) < maxKept) {
+                result.solutions.push_back(solution);
+            }
+        }
+    }
+    result.complete = !timedOut;
+    result.wallTimeMs = (SDL_GetTicksNS() - startTime) / 1e6;
+    result.solutionsPerSecond = result.wallTimeMs > 0 ? result.solutionCount * 1000.0 / result.wallTimeMs : 0;
+    return result;
+}
+
+bool PerfectClearSolver::startSearch(const Board& board, const Piece& active, const std::vector<PieceType>& queue,
+                                     int minRows, Uint32 budgetMs, int maxKept) {
+    if (searchState != SEARCH_IDLE) {
+        return false;
+    }
+    *searchBoard = board;  // Same dimensions after the first search, so the cell storage is reused
+    searchPiece->reset(active.getPieceX(), active.getPieceY(), active.getType(), active.getRotation());
+    searchQueue = queue;
+    searchMinRows = minRows;
+    searchBudgetMs = budgetMs;
+    searchMaxKept = maxKept;
+    searchState = SEARCH_RUNNING;
+    SDL_SignalSemaphore(searchStart);  // Publishes the copies above to the search thread
+    return true;
+}
+
+bool PerfectClearSolver::takeResult(PerfectClearResult& result, int& rows) {
+    if (searchState.load(std::memory_order_acquire) != SEARCH_DONE) {
+        return false;
+    }
+    result = searchResult;
+    rows = searchRows;
+    searchState.store(SEARCH_IDLE, std::memory_order_release);
+    return true;
+}
+
+int PerfectClearSolver::searchThread(void* data) {
+    PerfectClearSolver* solver = static_cast<PerfectClearSolver*>(data);
+    for (;;) {
+        SDL_WaitSemaphore(solver->searchStart);
+        if (solver->searchQuit) {
+            break;
+        }
+
+        // Cells already on the board: a perfect clear of 'rows' rows needs the rest filled by whole pieces
+        Board* board = solver->searchBoard;
+        int cells = 0;
+        for (int y = 0; y < board->getHeight(); ++y) {
+            for (int x = 0; x < board->getWidth(); ++x) {
+                if (!board->isCellEmpty(x, y)) cells++;
+            }
+        }
+
+        // Try each height, lowest first, each with what is left of the budget
+        Uint64 start = SDL_GetTicksNS();
+        Uint64 end = start + static_cast<Uint64>(solver->searchBudgetMs) * 1000000;
+        PerfectClearResult total;
+        total.complete = true;
+        int found = 0;
+        int minRows = solver->searchMinRows < MIN_ROWS ? MIN_ROWS : solver->searchMinRows;
+        for (int rows = minRows; rows <= MAX_ROWS && found == 0; ++rows) {
+            int missing = rows * board->getWidth() - cells;
+            if (missing <= 0 || missing % 4 != 0) {
+                continue;  // No number of pieces fills exactly this height
+            }
+            Uint64 now = SDL_GetTicksNS();
+            if (now >= end) {
+                total.complete = false;
+                break;
+            }
+            Uint32 budget = static_cast<Uint32>((end - now + 999999) / 1000000);
+            PerfectClearResult result = solver->solve(board, *solver->searchPiece, solver->searchQueue, rows, budget, solver->searchMaxKept);
+            total.solutionCount += result.solutionCount;
+            total.nodes += result.nodes;
+            total.complete = total.complete && result.complete;
+            if (!result.solutions.empty()) {
+                total.solutions.swap(result.solutions);
+                found = rows;
+            }
+        }
+        total.wallTimeMs = (SDL_GetTicksNS() - start) / 1e6;
+        total.solutionsPerSecond = total.wallTimeMs > 0 ? total.solutionCount * 1000.0 / total.wallTimeMs : 0;
+
+        solver->searchResult = total;
+        solver->searchRows = found;
+        solver->searchState.store(SEARCH_DONE, std::memory_order_release);
+    }
+    return 0;
+}
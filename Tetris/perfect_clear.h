@@ -0,0 +1,148 @@
+// perfect_clear.h
+
+#ifndef PERFECT_CLEAR_H
+#define PERFECT_CLEAR_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the worker threads, semaphores and timers
+#include <atomic>       // Include atomic for the counters shared by the workers
+#include <vector>       // Include vector for the placements and solutions
+
+class Board;            // Forward declaration of Board class
+class Piece;            // Forward declaration of Piece class
+enum class PieceType;   // Forward declaration of PieceType (defined in piece.h)
+
+// One piece of a perfect clear: which piece, how to turn it, and where it lands
+struct PerfectClearPlacement {
+    PieceType type;     // The piece being placed
+    int rotations;      // Clockwise rotations from the piece's shape when it is placed (0 to 3)
+    int x, y;           // Board position of the rotated piece when it lands (top-left of its shape)
+    int blocks[4][2];   // Board coordinates of its four blocks, on the board as it is when the piece is placed
+};
+
+// Outcome of one search
+struct PerfectClearResult {
+    std::vector<std::vector<PerfectClearPlacement>> solutions;  // Placement sequences found (up to the requested maximum)
+    Uint64 solutionCount = 0;       // Sequences found, including the ones not kept
+    Uint64 nodes = 0;               // Fields visited
+    double wallTimeMs = 0;          // Time spent in solve()
+    double solutionsPerSecond = 0;  // solutionCount / wall time
+    bool complete = false;          // True if the whole tree was searched before the time budget ran out
+};
+
+// PerfectClearSolver searches for placement sequences that empty the board.
+// The bottom rows of the board are packed into a 64-bit field (10 bits per row), pieces are hard dropped
+// in every rotation and column, full rows are removed and the height left to fill shrinks with them.
+// Fields known to lead nowhere are remembered so they are not searched twice. The first placements are
+// split into tasks shared by a pool of worker threads that is created once and reused for every search
+class PerfectClearSolver {
+public:
+    static const int MIN_ROWS = 4;  // Smallest search height
+    static const int MAX_ROWS = 6;  // Largest search height (6 rows of 10 cells fit in 64 bits)
+
+    // Constructor: starts 'threads' workers (0 uses one per logical CPU core, the caller included)
+    explicit PerfectClearSolver(int threads = 0);
+    ~PerfectClearSolver();
+
+    // Searches for perfect clears of the bottom 'rows' rows using the active piece then the queued pieces in order.
+    // The board must be empty above those rows. Stops after 'budgetMs' milliseconds and keeps up to 'maxKept' sequences
+    PerfectClearResult solve(Board* board, const Piece& active, const std::vector<PieceType>& queue,
+                             int rows, Uint32 budgetMs, int maxKept = 16);
+
+    // Starts a search on the solver's own thread and returns at once, so the caller never waits for it.
+    // Every height from 'minRows' to MAX_ROWS whose cell count allows a perfect clear is tried in turn, lowest
+    // first, until one has a solution or 'budgetMs' milliseconds have passed in all. The board and the active
+    // piece are copied. Returns false (and starts nothing) while the previous search has not been collected.
+    // Do not call solve() while a search started here is running
+    bool startSearch(const Board& board, const Piece& active, const std::vector<PieceType>& queue,
+                     int minRows, Uint32 budgetMs, int maxKept = 1);
+
+    // Collects the search started by startSearch() once it has finished: returns true once, with its
+    // result and the height it was found at (0 if no height had a solution); returns false while it runs
+    bool takeResult(PerfectClearResult& result, int& rows);
+
+    // Number of threads searching, the caller included
+    int threadCount() const { return static_cast<int>(workers.size()) + 1; }
+
+private:
+    // One rotation of a piece, as a bit mask of its blocks with its lowest row at row 0 and its left column at 0
+    struct Orientation {
+        Uint64 mask;        // Blocks, 10 bits per row, row 0 is the lowest
+        int width, height;  // Size of the rotated shape
+        int rotations;      // Rotations from the starting shape
+        int cells[4][2];    // Blocks as offsets in the shape (x to the right, y downwards)
+    };
+
+    // A piece of the sequence, in every distinct rotation
+    struct SequencePiece {
+        PieceType type;
+        std::vector<Orientation> orientations;
+    };
+
+    // Work item: the field left after the first placements
+    struct Task {
+        Uint64 field;
+        int ceiling;
+        int depth;
+        std::vector<PerfectClearPlacement> path;
+    };
+
+    // Per-thread search state
+    struct Worker;
+
+    // Builds the distinct rotations of a shape
+    static std::vector<Orientation> orientationsOf(const std::vector<std::vector<int>>& shape);
+
+    // Drops an orientation at column x; returns false if it does not fit under the ceiling.
+    // On success 'field' and 'ceiling' hold the result with full rows removed and 'placement' describes the move
+    bool place(const Orientation& o, PieceType type, int x, Uint64& field, int& ceiling, PerfectClearPlacement& placement) const;
+
+    // Checks if the field can still be emptied with 'piecesLeft' pieces
+    bool canFinish(Uint64 field, int ceiling, int piecesLeft) const;
+
+    // Depth-first search from a field; returns true if at least one perfect clear was found below it
+    bool search(Worker& worker, Uint64 field, int ceiling, int depth);
+
+    // Records a finished sequence
+    void addSolution(Worker& worker);
+
+    // Takes tasks until none are left (every thread of a search runs this)
+    void runTasks(Worker& worker);
+
+    // Pool thread loop: waits for a search, runs tasks, reports back
+    static int workerThread(void* data);
+
+    // Thread running the searches started by startSearch() (it is the caller of solve() for them)
+    static int searchThread(void* data);
+
+    std::vector<SDL_Thread*> workers;  // Pool threads (the caller of solve() is the last searcher)
+    SDL_Semaphore* startWork;          // Signalled once per pool thread when a search starts
+    SDL_Semaphore* workDone;           // Signalled by each pool thread when it runs out of tasks
+    std::atomic<bool> quit;            // Set to stop the pool
+
+    // Searches started by startSearch()
+    enum { SEARCH_IDLE, SEARCH_RUNNING, SEARCH_DONE };
+    SDL_Thread* searcher;              // Runs them
+    SDL_Semaphore* searchStart;        // Signalled when one is started (or to stop the thread)
+    std::atomic<bool> searchQuit;      // Set to stop the search thread (before the pool is stopped)
+    std::atomic<int> searchState;      // SEARCH_IDLE, SEARCH_RUNNING, or SEARCH_DONE until takeResult()
+    Board* searchBoard;                // Copy of the board it searches
+    Piece* searchPiece;                // Copy of the active piece
+    std::vector<PieceType> searchQueue;  // Queued pieces
+    int searchMinRows;                 // Lowest height to try
+    Uint32 searchBudgetMs;             // Time for all the heights together
+    int searchMaxKept;                 // Solutions to keep
+    PerfectClearResult searchResult;   // Outcome, valid once searchState is SEARCH_DONE
+    int searchRows;                    // Height the solutions were found at (0 if none)
+
+    // State of the current search (written by solve() before the workers are started)
+    std::vector<SequencePiece> sequence;  // Active piece then the queue
+    std::vector<Task> tasks;              // Subtrees to search
+    std::atomic<int> nextTask;            // Next task to hand out
+    std::atomic<bool> timedOut;           // Set once the deadline has passed
+    Uint64 deadline;                      // SDL_GetTicksNS() value at which the search stops
+    int maxSolutions;                     // Solutions to keep
+    int boardWidth, boardHeight;          // Board dimensions (to turn field rows into board rows)
+    std::vector<Worker*> states;          // Search state of each thread, the caller's last
+};
+
+#endif
@@ -16,108 +16,134 @@ std::map<PieceType, std::vector<std::vector<int>>> Piece::pieceShapes = {
 };
 
 // Constructor for the Piece class
-Piece::Piece(Game* g, Board* b, int x, int y, PieceType type) 
-    : game(g), board(b), pieceX(x), pieceY(y), type(type), shape(pieceShapes[type]) {
-
-    // Assign a color based on the piece type
-    switch (type) {
-        case PieceType::I: color = {0, 255, 255, 255}; break;
-        case PieceType::O: color = {255, 255, 0, 255}; break;
-        case PieceType::T: color = {128, 0, 128, 255}; break;
-        case PieceType::L: color = {255, 165, 0, 255}; break;
-        case PieceType::J: color = {0, 0, 255, 255}; break;
-        case PieceType::S: color = {0, 255, 0, 255}; break;
-        case PieceType::Z: color = {255, 0, 0, 255}; break;
-    }
-
-    updateBlocks(); // Update the blocks' positions based on the shape
+Piece::Piece(Game* g, Board* b, int x, int y, PieceType type) : game(g), board(b) {
+    reset(x, y, type);
 }
 
 // Destructor
 Piece::~Piece() {
 }
 
-// Updates the blocks of the piece based on the current shape
-void Piece::updateBlocks() {
-    blocks.clear(); // Clear previous blocks
-    // Iterate over the shape and create blocks where there is a 1 in the shape
-    for (int i = 0; i < shape.size(); ++i) {
-        for (int j = 0; j < shape[i].size(); ++j) {
-            if (shape[i][j] == 1) {
-                blocks.push_back({i, j}); // Store the block's relative position
+// Reuse the piece for a new one: only the position, type and rotation change
+void Piece::reset(int x, int y, PieceType t, int r) {
+    pieceX = x;
+    pieceY = y;
+    type = t;
+    color = colorFor(type); // Assign a color based on the piece type
+    rotations = &rotationsOf(type);
+    rotation = r % 4; // 0 is the spawn rotation: the shape from pieceShapes
+}
+
+// Build the rotations of every piece type from its shape in pieceShapes (once, on first use)
+const std::vector<Piece::Rotation>& Piece::rotationsOf(PieceType type) {
+    static const std::map<PieceType, std::vector<Rotation>> table = []() {
+        std::map<PieceType, std::vector<Rotation>> rotations;
+        for (const auto& entry : pieceShapes) {
+            std::vector<std::vector<int>> shape = entry.second;
+            for (int r = 0; r < 4; ++r) {
+                Rotation rotation;
+                rotation.shape = shape;
+                // Iterate over the shape and create blocks where there is a 1 in the shape
+                for (int i = 0; i < shape.size(); ++i) {
+                    for (int j = 0; j < shape[i].size(); ++j) {
+                        if (shape[i][j] == 1) {
+                            rotation.blocks.push_back({i, j}); // Store the block's relative position
+                        }
+                    }
+                }
+                rotations[entry.first].push_back(rotation);
+                shape = rotatedShape(shape);
             }
         }
+        return rotations;
+    }();
+    return table.find(type)->second;
+}
+
+// Returns the color of each piece type
+SDL_Color Piece::colorFor(PieceType type) {
+    switch (type) {
+        case PieceType::I: return {0, 255, 255, 255};
+        case PieceType::O: return {255, 255, 0, 255};
+        case PieceType::T: return {128, 0, 128, 255};
+        case PieceType::L: return {255, 165, 0, 255};
+        case PieceType::J: return {0, 0, 255, 255};
+        case PieceType::S: return {0, 255, 0, 255};
+        case PieceType::Z: return {255, 0, 0, 255};
     }
+    return {0, 0, 0, 0};
 }
 
 // Draw the piece on the screen using the provided SDL renderer
 void Piece::draw(SDL_Renderer* renderer) {
-    int blockSize = Board::CELL_SIZE; // Size of each block (from the board class)
-
     // Iterate over the blocks and draw each one
-    for (const auto& block : blocks) {
-        SDL_FRect rect = { 
-            static_cast<float>((pieceX + block.first) * blockSize), 
-            static_cast<float>((pieceY + block.second) * blockSize), 
-            static_cast<float>(blockSize), 
-            static_cast<float>(blockSize) 
-        };
-        SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a); // Set the color
-        SDL_RenderFillRect(renderer, &rect); // Fill the rectangle with the piece's color
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Set the border color
-        SDL_RenderRect(renderer, &rect); // Draw the border of the block
+    for (const auto& block : getBlock()) {
+        drawBlock(renderer, pieceX + block.first, pieceY + block.second, color);
     }
 }
 
+// Draw one block: filled with the piece's color and outlined in black
+void Piece::drawBlock(SDL_Renderer* renderer, int x, int y, SDL_Color color) {
+    int blockSize = Board::CELL_SIZE; // Size of each block (from the board class)
+
+    SDL_FRect rect = { 
+        static_cast<float>(x * blockSize), 
+        static_cast<float>(y * blockSize), 
+        static_cast<float>(blockSize), 
+        static_cast<float>(blockSize) 
+    };
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a); // Set the color
+    SDL_RenderFillRect(renderer, &rect); // Fill the rectangle with the piece's color
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255); // Set the border color
+    SDL_RenderRect(renderer, &rect); // Draw the border of the block
+}
+
 // Move the piece by a certain amount (dx, dy), if the move is valid (no collision)
 void Piece::movePiece(int dx, int dy) {
     if (!game->checkCollision(dx, dy)) {  // Check for collisions
         pieceX += dx; // Update the piece's X position
-        pieceY += dy; // Update the piece's Y position
-        updateBlocks(); // Update the blocks' positions based on the new coordinates
+        pieceY += dy; // Update the piece's Y position (blocks are relative to it, so they do not change)
     }
 }
 
-// Rotate the piece and check if the new position is valid
-void Piece::rotatePiece() {
-    // Create a new shape that is the rotated version of the current shape
-    std::vector<std::vector<int>> rotatedShape(shape[0].size(), std::vector<int>(shape.size()));
-    std::vector<std::pair<int, int>> newBlocks;
+// Rotated copy of a shape (also used to plan placements without moving a piece)
+std::vector<std::vector<int>> Piece::rotatedShape(const std::vector<std::vector<int>>& shape) {
+    std::vector<std::vector<int>> rotated(shape[0].size(), std::vector<int>(shape.size()));
 
     // Rotate the shape (90 degrees clockwise)
     for (int i = 0; i < shape.size(); ++i) {
         for (int j = 0; j < shape[i].size(); ++j) {
-            rotatedShape[shape[i].size() - 1 - j][i] = shape[i][j];
+            rotated[shape[i].size() - 1 - j][i] = shape[i][j];
         }
     }
+    return rotated;
+}
 
-    // Check if the rotated piece fits within the board and doesn't collide
-    for (int i = 0; i < rotatedShape.size(); ++i) {
-        for (int j = 0; j < rotatedShape[i].size(); ++j) {
-            if (rotatedShape[i][j] == 1) {
-                int newX = pieceX + i;
-                int newY = pieceY + j;
-                
-                // Check if the new position is valid (within bounds and not colliding)
-                if (newX < 0 || newX >= board->getWidth() ||
-                    newY < 0 || newY >= board->getHeight() || 
-                    !board->isCellEmpty(newX, newY)) {
-                    return; // If invalid, return without rotating
-                }
+// Rotate the piece and check if the new position is valid
+void Piece::rotatePiece() {
+    // The next rotation (90 degrees clockwise) is already computed
+    int next = (rotation + 1) % 4;
 
-                newBlocks.push_back({i, j}); // Store the new block's position
-            }
+    // Check if the rotated piece fits within the board and doesn't collide
+    for (const auto& block : (*rotations)[next].blocks) {
+        int newX = pieceX + block.first;
+        int newY = pieceY + block.second;
+
+        // Check if the new position is valid (within bounds and not colliding)
+        if (newX < 0 || newX >= board->getWidth() ||
+            newY < 0 || newY >= board->getHeight() || 
+            !board->isCellEmpty(newX, newY)) {
+            return; // If invalid, return without rotating
         }
     }
 
-    // If valid, update the shape and blocks with the rotated version
-    shape = rotatedShape;
-    blocks = newBlocks;
+    // If valid, switch to the rotated shape and blocks
+    rotation = next;
 }
 
 // Returns the blocks of the piece (used to access their positions)
 const std::vector<std::pair<int, int>>& Piece::getBlock() const {
-    return blocks;
+    return (*rotations)[rotation].blocks;
 }
 
 // Returns the color of the piece
@@ -24,8 +24,15 @@ public:
     // Destructor
     ~Piece();
     
+    // Turns this piece into a new one of the given type at (x, y), in its spawn rotation or the given one
+    // (nothing is allocated)
+    void reset(int x, int y, PieceType type, int rotation = 0);
+    
     // Draw the piece on the screen using SDL renderer
     void draw(SDL_Renderer* renderer);
+    
+    // Draw a single block of the given color at board coordinates (x, y)
+    static void drawBlock(SDL_Renderer* renderer, int x, int y, SDL_Color color);
 
     // Move the piece by dx and dy
     void movePiece(int dx, int dy);
@@ -33,8 +40,8 @@ public:
     // Rotate the piece 90 degrees
     void rotatePiece();
     
-    // Helper function to update the block positions based on the shape
-    void updateBlocks();
+    // Returns the given shape rotated 90 degrees clockwise (the rotation rotatePiece applies)
+    static std::vector<std::vector<int>> rotatedShape(const std::vector<std::vector<int>>& shape);
     
     // Get the current blocks that make up the piece
 	const std::vector<std::pair<int, int>>& getBlock() const;
@@ -42,6 +49,18 @@ public:
     // Get the color of the piece
 	SDL_Color getColor() const;
 
+    // Get the type of the piece
+	PieceType getType() const { return type; }
+
+    // Get the current rotation of the piece (0 as spawned, then one more per clockwise turn, modulo 4)
+	int getRotation() const { return rotation; }
+
+    // Get the current (possibly rotated) shape of the piece
+	const std::vector<std::vector<int>>& getShape() const { return (*rotations)[rotation].shape; }
+
+    // Get the color used for a given piece type
+	static SDL_Color colorFor(PieceType type);
+
     // Set the board the piece is associated with
 	void setBoard(Board* b) { board = b; }
 
@@ -53,6 +72,16 @@ public:
     static std::map<PieceType, std::vector<std::vector<int>>> pieceShapes;
 
 private:
+    // One rotation of a piece type: its shape and the blocks it is made of
+    struct Rotation {
+        std::vector<std::vector<int>> shape;
+        std::vector<std::pair<int, int>> blocks;
+    };
+
+    // The four rotations of a piece type, computed the first time they are needed and shared by every piece,
+    // so moving and rotating a piece never allocates
+    static const std::vector<Rotation>& rotationsOf(PieceType type);
+
     // Pointer to the associated game instance
 	Game* game;
 
@@ -68,14 +97,12 @@ private:
     // The type of the piece (I, O, T, L, J, S, Z)
     PieceType type;
 
-    // Shape of the piece, represented as a 2D vector (block structure)
-    std::vector<std::vector<int>> shape;
+    // Rotations of the piece's type, and the current one (its shape and blocks)
+    const std::vector<Rotation>* rotations;
+    int rotation;
 
     // The color of the piece
     SDL_Color color;
-
-    // A list of blocks (as pairs of coordinates) that make up the piece
-    std::vector<std::pair<int, int>> blocks;
 };
 
 #endif
@@ -0,0 +1,613 @@
+// piece_stats.cpp
+
+#include <cstring>        // Include for memcpy
+
+#include "piece_stats.h"  // Includes the statistics file types
+
+#ifdef _WIN32
+#include <windows.h>      // Include for CreateFileMapping / MapViewOfFile
+#include <io.h>           // Include for _chsize_s
+#else
+#include <sys/mman.h>     // Include for mmap
+#include <sys/stat.h>     // Include for fstat
+#include <fcntl.h>        // Include for open
+#include <unistd.h>       // Include for close / ftruncate
+#endif
+
+// A record is one value per column, in column order
+static_assert(sizeof(PieceStatsRecord) == sizeof(Sint32) * PIECE_STATS_COLUMNS, "PieceStatsRecord must match the columns");
+
+// Offset of the first chunk of a block: the header, rounded up so chunks start on 8-byte boundaries
+static const Uint32 BLOCK_DATA_OFFSET = (sizeof(PieceStatsBlockHeader) + 7) & ~7u;
+
+static Uint32 roundUp8(size_t size) {
+    return static_cast<Uint32>((size + 7) & ~static_cast<size_t>(7));
+}
+
+// Variable-length integers: 7 bits per byte, low bits first, high bit set when more bytes follow
+static void putVarint(std::vector<Uint8>& out, Uint64 value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<Uint8>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<Uint8>(value));
+}
+
+// Reads one variable-length integer without going past 'end'; returns false if it does not end before 'end'
+static bool getVarint(const Uint8*& in, const Uint8* end, Uint64& value) {
+    value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        Uint8 byte = *in++;
+        value |= static_cast<Uint64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Signed differences as unsigned numbers that stay small when the difference is small: 0, -1, 1, -2, 2...
+static Uint64 zigzag(Sint64 value) {
+    return (static_cast<Uint64>(value) << 1) ^ static_cast<Uint64>(value >> 63);
+}
+
+static Sint64 unzigzag(Uint64 value) {
+    return static_cast<Sint64>(value >> 1) ^ -static_cast<Sint64>(value & 1);
+}
+
+// Encodes one column of 'rows' values at the end of 'out' (padded to 8 bytes), choosing whichever encoding is smaller
+static void encodeColumn(const Sint32* values, int rows, PieceStatsChunk& chunk, std::vector<Uint8>& out, std::vector<Uint8>& runs) {
+    Sint32 min = values[0], max = values[0];
+    for (int i = 1; i < rows; ++i) {
+        if (values[i] < min) min = values[i];
+        if (values[i] > max) max = values[i];
+    }
+    Uint64 range = static_cast<Uint64>(static_cast<Sint64>(max) - min);
+    int bits = 0;
+    while ((range >> bits) != 0) {
+        bits++;
+    }
+    Uint32 packedSize = roundUp8((static_cast<size_t>(rows) * bits + 7) / 8);
+
+    // Runs: worth it for columns that change rarely (game number, speed, and many values in sorted data)
+    runs.clear();
+    Sint64 previous = 0;
+    for (int i = 0; i < rows; ) {
+        int length = 1;
+        while (i + length < rows && values[i + length] == values[i]) {
+            length++;
+        }
+        putVarint(runs, zigzag(values[i] - previous));
+        putVarint(runs, static_cast<Uint64>(length));
+        previous = values[i];
+        i += length;
+    }
+
+    chunk.offset = static_cast<Uint32>(out.size());
+    chunk.bits = static_cast<Uint8>(bits);
+    chunk.reserved = 0;
+    chunk.min = min;
+    chunk.max = max;
+    if (roundUp8(runs.size()) < packedSize) {
+        chunk.encoding = static_cast<Uint8>(PieceStatsEncoding::Runs);
+        chunk.size = roundUp8(runs.size());
+        out.insert(out.end(), runs.begin(), runs.end());
+    } else {
+        // Values minus the minimum, 'bits' bits each, filling 64-bit words from their low bits
+        chunk.encoding = static_cast<Uint8>(PieceStatsEncoding::Packed);
+        chunk.size = packedSize;
+        Uint64 word = 0;
+        int filled = 0;
+        for (int i = 0; i < rows && bits > 0; ++i) {
+            Uint64 value = static_cast<Uint64>(static_cast<Sint64>(values[i]) - min);
+            word |= value << filled;
+            filled += bits;
+            if (filled >= 64) {
+                out.insert(out.end(), reinterpret_cast<Uint8*>(&word), reinterpret_cast<Uint8*>(&word) + 8);
+                filled -= 64;
+                word = filled > 0 ? value >> (bits - filled) : 0;
+            }
+        }
+        if (filled > 0) {
+            out.insert(out.end(), reinterpret_cast<Uint8*>(&word), reinterpret_cast<Uint8*>(&word) + 8);
+        }
+    }
+    out.resize(chunk.offset + chunk.size, 0);
+}
+
+const char* pieceStatsColumnName(PieceStatsColumn column) {
+    switch (column) {
+        case PieceStatsColumn::Game: return "game";
+        case PieceStatsColumn::Piece: return "piece";
+        case PieceStatsColumn::Type: return "type";
+        case PieceStatsColumn::X: return "x";
+        case PieceStatsColumn::Y: return "y";
+        case PieceStatsColumn::Rotation: return "rotation";
+        case PieceStatsColumn::Lines: return "lines";
+        case PieceStatsColumn::ScoreDelta: return "score_delta";
+        case PieceStatsColumn::Score: return "score";
+        case PieceStatsColumn::Speed: return "speed";
+        case PieceStatsColumn::LockTime: return "lock_time";
+        case PieceStatsColumn::Height: return "height";
+        case PieceStatsColumn::Holes: return "holes";
+        default: return "?";
+    }
+}
+
+PieceStatsFile::PieceStatsFile() : data(nullptr), mappedSize(0), maxBlockRows(0), totalRows(0), blocksEnd(0), rebuilt(false) {
+#ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    handle = nullptr;
+#endif
+}
+
+PieceStatsFile::~PieceStatsFile() {
+    close();
+}
+
+bool PieceStatsFile::open(const std::string& path) {
+    if (!map(path) || mappedSize < sizeof(PieceStatsFileHeader)) {
+        close();
+        return false;
+    }
+    PieceStatsFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != PieceStatsFileHeader::MAGIC || header.version != PieceStatsFileHeader::VERSION ||
+        header.columns != PIECE_STATS_COLUMNS || header.blockRows == 0) {
+        close();
+        return false;
+    }
+    maxBlockRows = header.blockRows;
+
+    // Use the index written by the last writer if the footer points to it and it describes valid blocks.
+    // Otherwise (the writer did not close the file, or a stale footer survived) walk the blocks instead
+    if (!readIndex()) {
+        rebuildIndex();
+    }
+    totalRows = 0;
+    for (const PieceStatsIndexEntry& entry : index) {
+        totalRows += entry.rows;
+    }
+    return true;
+}
+
+bool PieceStatsFile::readIndex() {
+    PieceStatsFooter footer;
+    if (mappedSize < sizeof(PieceStatsFileHeader) + sizeof(footer)) {
+        return false;
+    }
+    std::memcpy(&footer, data + mappedSize - sizeof(footer), sizeof(footer));
+    if (footer.magic != PieceStatsFooter::MAGIC || footer.indexOffset < sizeof(PieceStatsFileHeader) ||
+        footer.indexOffset + sizeof(footer) > mappedSize ||
+        mappedSize - footer.indexOffset - sizeof(footer) != static_cast<Uint64>(footer.blocks) * sizeof(PieceStatsIndexEntry)) {
+        return false;
+    }
+    index.resize(footer.blocks);
+    if (footer.blocks > 0) {
+        std::memcpy(&index[0], data + footer.indexOffset, footer.blocks * sizeof(PieceStatsIndexEntry));
+    }
+
+    // The blocks must follow each other from the header to the index, and agree with their entries
+    Uint64 offset = sizeof(PieceStatsFileHeader);
+    for (const PieceStatsIndexEntry& entry : index) {
+        if (entry.offset != offset || !validBlock(offset, footer.indexOffset)) {
+            index.clear();
+            return false;
+        }
+        const PieceStatsBlockHeader* block = reinterpret_cast<const PieceStatsBlockHeader*>(data + offset);
+        if (block->rows != entry.rows) {
+            index.clear();
+            return false;
+        }
+        offset += block->size;
+    }
+    if (offset != footer.indexOffset) {
+        index.clear();
+        return false;
+    }
+    blocksEnd = footer.indexOffset;
+    rebuilt = false;
+    return true;
+}
+
+void PieceStatsFile::rebuildIndex() {
+    // Walk the blocks from the header, stopping at the first incomplete or damaged one
+    index.clear();
+    Uint64 offset = sizeof(PieceStatsFileHeader);
+    while (validBlock(offset, mappedSize)) {
+        const PieceStatsBlockHeader* block = reinterpret_cast<const PieceStatsBlockHeader*>(data + offset);
+        PieceStatsIndexEntry entry;
+        SDL_zero(entry);
+        entry.offset = offset;
+        entry.rows = block->rows;
+        for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+            entry.min[c] = block->chunks[c].min;
+            entry.max[c] = block->chunks[c].max;
+        }
+        index.push_back(entry);
+        offset += block->size;
+    }
+    blocksEnd = offset;
+    rebuilt = true;
+}
+
+bool PieceStatsFile::validBlock(Uint64 offset, Uint64 end) const {
+    if (offset % 8 != 0 || end > mappedSize || offset + BLOCK_DATA_OFFSET > end) {
+        return false;
+    }
+    const PieceStatsBlockHeader* block = reinterpret_cast<const PieceStatsBlockHeader*>(data + offset);
+    if (block->magic != PieceStatsBlockHeader::MAGIC || block->size < BLOCK_DATA_OFFSET || block->size % 8 != 0 ||
+        offset + block->size > end || block->rows == 0 || block->rows > maxBlockRows) {
+        return false;
+    }
+
+    // Every chunk must lie inside the block, and a packed chunk must hold all of its rows
+    for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+        const PieceStatsChunk& chunk = block->chunks[c];
+        if (chunk.offset < BLOCK_DATA_OFFSET || chunk.offset % 8 != 0 ||
+            static_cast<Uint64>(chunk.offset) + chunk.size > block->size || chunk.min > chunk.max) {
+            return false;
+        }
+        if (chunk.encoding == static_cast<Uint8>(PieceStatsEncoding::Packed)) {
+            if (chunk.bits > 32 || static_cast<Uint64>(chunk.size) * 8 < static_cast<Uint64>(block->rows) * chunk.bits) {
+                return false;
+            }
+        } else if (chunk.encoding != static_cast<Uint8>(PieceStatsEncoding::Runs)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PieceStatsFile::map(const std::string& path) {
+    close();
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* memory = handle ? MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!memory) {
+        if (handle) CloseHandle(handle);
+        CloseHandle(file);
+        handle = nullptr;
+        file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    mappedSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+    void* memory = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping stays valid without the descriptor
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+    madvise(memory, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);  // Queries read the blocks in order
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+    data = static_cast<const Uint8*>(memory);
+    return true;
+}
+
+void PieceStatsFile::close() {
+    if (data) {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(handle);
+        CloseHandle(file);
+        handle = nullptr;
+        file = INVALID_HANDLE_VALUE;
+#else
+        munmap(const_cast<Uint8*>(data), mappedSize);
+#endif
+    }
+    data = nullptr;
+    mappedSize = 0;
+    maxBlockRows = 0;
+    index.clear();
+    totalRows = 0;
+    blocksEnd = 0;
+    rebuilt = false;
+}
+
+const PieceStatsBlockHeader& PieceStatsFile::blockHeader(int i) const {
+    return *reinterpret_cast<const PieceStatsBlockHeader*>(data + index[i].offset);
+}
+
+void PieceStatsFile::decode(int i, PieceStatsColumn column, Sint32* values) const {
+    const PieceStatsBlockHeader& block = blockHeader(i);
+    const PieceStatsChunk& chunk = block.chunks[static_cast<int>(column)];
+    const Uint8* in = data + index[i].offset + chunk.offset;
+    int rows = static_cast<int>(block.rows);
+
+    if (chunk.encoding == static_cast<Uint8>(PieceStatsEncoding::Runs)) {
+        // Every read stays inside the chunk; rows a damaged chunk does not cover get its minimum
+        const Uint8* end = in + chunk.size;
+        Sint64 value = 0;
+        int row = 0;
+        while (row < rows) {
+            Uint64 delta, length;
+            if (!getVarint(in, end, delta) || !getVarint(in, end, length) || length == 0) {
+                break;
+            }
+            value += unzigzag(delta);
+            int last = length < static_cast<Uint64>(rows - row) ? row + static_cast<int>(length) : rows;
+            for (; row < last; ++row) {
+                values[row] = static_cast<Sint32>(value);
+            }
+        }
+        for (; row < rows; ++row) {
+            values[row] = chunk.min;
+        }
+        return;
+    }
+
+    // Packed: a constant column has no data at all (open() checked the chunk holds 'rows' values)
+    int bits = chunk.bits;
+    if (bits == 0) {
+        for (int row = 0; row < rows; ++row) {
+            values[row] = chunk.min;
+        }
+        return;
+    }
+    Uint64 mask = (static_cast<Uint64>(1) << bits) - 1;
+    Uint64 words = chunk.size / 8;
+    for (int row = 0; row < rows; ++row) {
+        Uint64 bit = static_cast<Uint64>(row) * bits;
+        Uint64 word = bit >> 6;
+        int shift = static_cast<int>(bit & 63);
+        Uint64 low;
+        std::memcpy(&low, in + word * 8, 8);
+        Uint64 value = low >> shift;
+        if (shift + bits > 64 && word + 1 < words) {
+            Uint64 high;
+            std::memcpy(&high, in + (word + 1) * 8, 8);
+            value |= high << (64 - shift);
+        }
+        values[row] = static_cast<Sint32>(chunk.min + static_cast<Sint64>(value & mask));
+    }
+}
+
+// Moves to a position of a file that may be larger than 2 GB
+static bool seekTo(FILE* file, Uint64 offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+// Sets the size of the file under a stream, without flushing it
+static bool resizeTo(FILE* file, Uint64 size) {
+#ifdef _WIN32
+    return _chsize_s(_fileno(file), static_cast<__int64>(size)) == 0;
+#else
+    return ftruncate(fileno(file), static_cast<off_t>(size)) == 0;
+#endif
+}
+
+// Shortens a file to 'size' bytes
+static bool truncateTo(FILE* file, Uint64 size) {
+    return std::fflush(file) == 0 && resizeTo(file, size);
+}
+
+PieceStatsWriter::PieceStatsWriter() : file(nullptr), offset(0), game(-1), filling(0), pending(0), queuedBuffer(0), queuedRows(0),
+                                       blockQueued(nullptr), writerIdle(nullptr), thread(nullptr), running(false), failed(false) {
+}
+
+PieceStatsWriter::~PieceStatsWriter() {
+    close();
+}
+
+bool PieceStatsWriter::open(const std::string& path) {
+    close();
+
+    // Reserve every buffer now, so appending records never allocates, and room in the index for this run's blocks
+    for (int b = 0; b < 2; ++b) {
+        for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+            columns[b][c].resize(BLOCK_ROWS);
+        }
+    }
+    encoded.reserve(BLOCK_DATA_OFFSET + PIECE_STATS_COLUMNS * (BLOCK_ROWS * 4 + 8));
+    runs.reserve(BLOCK_ROWS * 15);
+    index.clear();
+    filling = 0;
+    pending = 0;
+    failed = false;
+
+    // Append to an existing file: new blocks go where its index starts, and game numbers carry on
+    PieceStatsFile existing;
+    if (existing.open(path)) {
+        game = -1;
+        index.reserve(existing.blockCount() + INDEX_RESERVE);
+        for (int i = 0; i < existing.blockCount(); ++i) {
+            index.push_back(existing.block(i));
+            int lastGame = existing.block(i).max[static_cast<int>(PieceStatsColumn::Game)];
+            if (lastGame > game) game = lastGame;
+        }
+        offset = existing.dataEnd();
+        existing.close();
+        // Cut the old index and footer off before writing anything, so a writer that stops early leaves no
+        // footer pointing into the new blocks
+        file = std::fopen(path.c_str(), "r+b");
+        if (!file || !truncateTo(file, offset) || !seekTo(file, offset)) {
+            if (file) std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+    } else {
+        // Never overwrite a file that is something else
+        FILE* other = std::fopen(path.c_str(), "rb");
+        if (other) {
+            bool empty = std::fgetc(other) == EOF;
+            std::fclose(other);
+            if (!empty) {
+                return false;
+            }
+        }
+
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        PieceStatsFileHeader header = {PieceStatsFileHeader::MAGIC, PieceStatsFileHeader::VERSION,
+                                       static_cast<Uint32>(PIECE_STATS_COLUMNS), static_cast<Uint32>(BLOCK_ROWS)};
+        if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+            std::fclose(file);
+            file = nullptr;
+            return false;
+        }
+        index.reserve(INDEX_RESERVE);
+        offset = sizeof(header);
+        game = -1;
+    }
+
+    blockQueued = SDL_CreateSemaphore(0);
+    writerIdle = SDL_CreateSemaphore(1);
+    running = true;
+    thread = SDL_CreateThread(writerThread, "stats writer", this);
+    if (!thread) {
+        running = false;
+        SDL_DestroySemaphore(blockQueued);
+        SDL_DestroySemaphore(writerIdle);
+        blockQueued = writerIdle = nullptr;
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void PieceStatsWriter::startGame() {
+    game++;
+}
+
+void PieceStatsWriter::append(const PieceStatsRecord& record) {
+    if (!file || failed) {
+        return;  // After a write error, keep what was written; the index is rebuilt from the blocks when the file is read
+    }
+    Sint32 values[PIECE_STATS_COLUMNS];
+    std::memcpy(values, &record, sizeof(values));
+    values[static_cast<int>(PieceStatsColumn::Game)] = game < 0 ? 0 : game;
+    for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+        columns[filling][c][pending] = values[c];
+    }
+    if (++pending == BLOCK_ROWS) {
+        queueBlock();
+    }
+}
+
+void PieceStatsWriter::queueBlock() {
+    // The writer is idle once it has written the previous block, so the other buffer is free too
+    SDL_WaitSemaphore(writerIdle);
+    queuedBuffer = filling;
+    queuedRows = pending;
+    SDL_SignalSemaphore(blockQueued);
+    filling = 1 - filling;
+    pending = 0;
+}
+
+int PieceStatsWriter::writerThread(void* data) {
+    static_cast<PieceStatsWriter*>(data)->writeBlocks();
+    return 0;
+}
+
+void PieceStatsWriter::writeBlocks() {
+    for (;;) {
+        SDL_WaitSemaphore(blockQueued);
+        if (queuedRows == 0) {
+            if (!running) {
+                return;  // close() queues nothing and clears 'running' to stop the thread
+            }
+            continue;
+        }
+        if (!failed && !writeBlock(queuedBuffer, queuedRows)) {
+            failed = true;
+        }
+        queuedRows = 0;
+        SDL_SignalSemaphore(writerIdle);
+    }
+}
+
+bool PieceStatsWriter::writeBlock(int buffer, int rows) {
+    PieceStatsBlockHeader header;
+    SDL_zero(header);
+    header.magic = PieceStatsBlockHeader::MAGIC;
+    header.rows = static_cast<Uint32>(rows);
+
+    encoded.assign(BLOCK_DATA_OFFSET, 0);
+    PieceStatsIndexEntry entry;
+    SDL_zero(entry);
+    for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+        encodeColumn(columns[buffer][c].data(), rows, header.chunks[c], encoded, runs);
+        entry.min[c] = header.chunks[c].min;
+        entry.max[c] = header.chunks[c].max;
+    }
+    header.size = static_cast<Uint32>(encoded.size());
+    std::memcpy(encoded.data(), &header, sizeof(header));
+
+    // Flushed right away, so a game that crashes loses at most the blocks it had not finished
+    if (std::fwrite(encoded.data(), encoded.size(), 1, file) != 1 || std::fflush(file) != 0) {
+        return false;
+    }
+    entry.offset = offset;
+    entry.rows = header.rows;
+    index.push_back(entry);
+    offset += encoded.size();
+    return true;
+}
+
+bool PieceStatsWriter::close() {
+    if (!file) {
+        return true;
+    }
+    if (pending > 0 && !failed) {
+        queueBlock();
+    }
+
+    // Wait for the last block, then stop the writer thread
+    SDL_WaitSemaphore(writerIdle);
+    running = false;
+    SDL_SignalSemaphore(blockQueued);
+    SDL_WaitThread(thread, nullptr);
+    SDL_DestroySemaphore(blockQueued);
+    SDL_DestroySemaphore(writerIdle);
+    thread = nullptr;
+    blockQueued = writerIdle = nullptr;
+
+    // The index goes after the last block; the next writer to append overwrites it with new blocks.
+    // After a write error it is left out, and readers rebuild it from the blocks
+    bool indexed = false;
+    if (!failed) {
+        PieceStatsFooter footer;
+        SDL_zero(footer);
+        footer.indexOffset = offset;
+        footer.blocks = static_cast<Uint32>(index.size());
+        footer.magic = PieceStatsFooter::MAGIC;
+        indexed = (index.empty() || std::fwrite(&index[0], sizeof(PieceStatsIndexEntry), index.size(), file) == index.size()) &&
+                  std::fwrite(&footer, sizeof(footer), 1, file) == 1 && std::fflush(file) == 0;
+    }
+    if (!indexed) {
+        // Cut a partly written block or index off, so the file ends with the last complete block
+        resizeTo(file, offset);
+    }
+    bool closed = std::fclose(file) == 0;
+    file = nullptr;
+    pending = 0;
+    return indexed && closed;
+}
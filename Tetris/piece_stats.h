@@ -0,0 +1,206 @@
+// piece_stats.h
+
+#ifndef PIECE_STATS_H
+#define PIECE_STATS_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the fixed-size integer types
+#include <atomic>       // Include atomic for the writer thread's failure flag
+#include <cstdio>       // Include for FILE
+#include <string>       // Include string for file paths
+#include <vector>       // Include vector for the block index and the column buffers
+
+// Metrics of one placed piece, recorded when it locks
+struct PieceStatsRecord {
+    Sint32 game;        // Game number within the file (set by the writer)
+    Sint32 piece;       // Spawn number of the piece in its game (1 for the first piece)
+    Sint32 type;        // PieceType of the piece
+    Sint32 x, y;        // Position the piece locked at
+    Sint32 rotation;    // Rotation it locked in (0 to 3)
+    Sint32 lines;       // Lines cleared by Board::clearFullLines when it locked
+    Sint32 scoreDelta;  // Points scored by those lines
+    Sint32 score;       // Score after the lines were cleared
+    Sint32 speed;       // Gravity delay (ms) the piece fell at
+    Sint32 lockTime;    // Simulation time (ms) from spawn to lock (0 for games not driven by simulationTick)
+    Sint32 height;      // Stack height after the lines were cleared
+    Sint32 holes;       // Holes in the board after the lines were cleared
+};
+
+// Columns of the file, in PieceStatsRecord order
+enum class PieceStatsColumn { Game, Piece, Type, X, Y, Rotation, Lines, ScoreDelta, Score, Speed, LockTime, Height, Holes, Count };
+
+static const int PIECE_STATS_COLUMNS = static_cast<int>(PieceStatsColumn::Count);
+
+// How the values of one column of one block are stored
+enum class PieceStatsEncoding : Uint8 {
+    Packed,  // value - min in 'bits' bits per row (no data at all when every value is the same)
+    Runs     // (value - previous run's value, run length) pairs, both as variable-length integers
+};
+
+// The file is append-only: a header, then blocks of up to BLOCK_ROWS records stored column by column,
+// then the block index and a footer pointing to it. Appending cuts the old index and footer off, writes
+// new blocks in their place and writes the index again after them. If a writer stops before writing the
+// index, or the index does not match the blocks, readers rebuild it from the block headers. Everything is in the byte order of the machine that wrote it
+struct PieceStatsFileHeader {
+    static const Uint32 MAGIC = 0x54535050;  // "PPST"
+    static const Uint32 VERSION = 1;
+
+    Uint32 magic;       // MAGIC
+    Uint32 version;     // VERSION of the layout
+    Uint32 columns;     // PIECE_STATS_COLUMNS
+    Uint32 blockRows;   // Records per full block
+};
+
+// Where one column of a block is and how to decode it
+struct PieceStatsChunk {
+    Uint32 offset;      // From the start of the block, a multiple of 8
+    Uint32 size;        // Bytes of encoded data (a multiple of 8)
+    Uint8 encoding;     // PieceStatsEncoding
+    Uint8 bits;         // Bits per value (Packed)
+    Uint16 reserved;
+    Sint32 min, max;    // Smallest and largest value in the block
+};
+
+// Start of every block
+struct PieceStatsBlockHeader {
+    static const Uint32 MAGIC = 0x4b4c4250;  // "PBLK"
+
+    Uint32 magic;       // MAGIC
+    Uint32 rows;        // Records in the block
+    Uint32 size;        // Bytes of the whole block, header included (a multiple of 8)
+    Uint32 reserved;
+    PieceStatsChunk chunks[PIECE_STATS_COLUMNS];
+};
+
+// One entry of the block index: enough to skip a block without touching it
+struct PieceStatsIndexEntry {
+    Uint64 offset;      // Offset of the block in the file
+    Uint32 rows;        // Records in the block
+    Uint32 reserved;
+    Sint32 min[PIECE_STATS_COLUMNS];  // Smallest value of each column in the block
+    Sint32 max[PIECE_STATS_COLUMNS];  // Largest value of each column in the block
+};
+
+// End of the file
+struct PieceStatsFooter {
+    static const Uint32 MAGIC = 0x58444950;  // "PIDX"
+
+    Uint64 indexOffset; // Offset of the first index entry
+    Uint32 blocks;      // Number of index entries
+    Uint32 magic;       // MAGIC
+};
+
+// Name of a column, for reports and queries ("holes", "speed", ...)
+const char* pieceStatsColumnName(PieceStatsColumn column);
+
+// Maps a statistics file read-only and decodes its columns
+class PieceStatsFile {
+public:
+    PieceStatsFile();
+    ~PieceStatsFile();
+
+    // Maps the file and reads (or rebuilds) its block index; returns false if it is not a statistics file
+    bool open(const std::string& path);
+
+    // Unmaps the file
+    void close();
+
+    // Blocks of the file, from the index
+    int blockCount() const { return static_cast<int>(index.size()); }
+    const PieceStatsIndexEntry& block(int i) const { return index[i]; }
+    const PieceStatsBlockHeader& blockHeader(int i) const;
+
+    // Total number of records
+    Uint64 rows() const { return totalRows; }
+
+    // Offset where the blocks end (where a writer appends the next one)
+    Uint64 dataEnd() const { return blocksEnd; }
+
+    // True if the footer was missing and the index was rebuilt from the block headers
+    bool recovered() const { return rebuilt; }
+
+    // Decodes one column of a block into 'values' (block(i).rows entries)
+    void decode(int i, PieceStatsColumn column, Sint32* values) const;
+
+private:
+    bool map(const std::string& path);
+
+    // Reads the index the footer points to; false if there is none or it does not match the blocks
+    bool readIndex();
+
+    // Builds the index by walking the block headers from the start of the file
+    void rebuildIndex();
+
+    // Checks that a block header and all of its chunks lie before 'end' and can be decoded safely
+    bool validBlock(Uint64 offset, Uint64 end) const;
+
+    const Uint8* data;                       // Mapped file
+    size_t mappedSize;                       // Size of the mapping in bytes
+    Uint32 maxBlockRows;                     // Most records a block may hold (from the file header)
+    std::vector<PieceStatsIndexEntry> index; // One entry per block
+    Uint64 totalRows;                        // Sum of the rows of every block
+    Uint64 blocksEnd;                        // End of the last block
+    bool rebuilt;                            // True if the index came from the block headers
+#ifdef _WIN32
+    void* file;                              // File handle
+    void* handle;                            // File mapping handle
+#endif
+};
+
+// Appends records to a statistics file, one block at a time. Records are collected in one of two column
+// buffers; each time BLOCK_ROWS have been appended the buffer is handed to a writer thread, which encodes,
+// writes and flushes the block and adds it to the index while the other buffer fills. append() only waits
+// if the writer has not finished the previous block by then. The index is written by close()
+class PieceStatsWriter {
+public:
+    static const int BLOCK_ROWS = 8192;  // Records per block
+    static const int INDEX_RESERVE = 1024;  // Index entries reserved by open() for the blocks of one run
+
+    PieceStatsWriter();
+    ~PieceStatsWriter();
+
+    // Creates the file, or opens an existing one to append to it; returns false on failure
+    bool open(const std::string& path);
+
+    // Checks if the writer has a file to write to
+    bool isOpen() const { return file != nullptr; }
+
+    // Starts a new game: the records appended from now on get the next game number
+    void startGame();
+
+    // Appends the record of one placed piece (its game number is set by the writer)
+    void append(const PieceStatsRecord& record);
+
+    // Writes the pending records as a block, stops the writer thread, then writes the index and the footer
+    // and closes the file. Returns false if a block, the index or the footer could not be written: the file
+    // then ends after its last complete block, and readers rebuild the index
+    bool close();
+
+private:
+    // Hands the 'pending' records of the filling buffer to the writer thread and switches buffers
+    void queueBlock();
+
+    // Encodes the records of a buffer as one block and writes it (writer thread)
+    bool writeBlock(int buffer, int rows);
+
+    // Writer thread loop
+    void writeBlocks();
+    static int writerThread(void* data);
+
+    FILE* file;                                             // Open file, null when closed
+    Uint64 offset;                                          // Where the next block goes (writer thread)
+    Sint32 game;                                            // Game number of the records being appended
+    int filling;                                            // Buffer the records are appended to
+    int pending;                                            // Records waiting in the filling buffer
+    std::vector<Sint32> columns[2][PIECE_STATS_COLUMNS];    // Two buffers of values, column by column (BLOCK_ROWS each)
+    int queuedBuffer, queuedRows;                           // Block handed to the writer thread
+    SDL_Semaphore* blockQueued;                             // Wakes the writer when a block is queued
+    SDL_Semaphore* writerIdle;                              // Signaled when the writer can take a block
+    SDL_Thread* thread;                                     // Writer thread
+    std::atomic<bool> running;                              // Cleared to stop the writer
+    std::atomic<bool> failed;                               // Set by the writer if a block could not be written
+    std::vector<Uint8> encoded;                             // Block being encoded (writer thread)
+    std::vector<Uint8> runs;                                // Scratch for trying the Runs encoding (writer thread)
+    std::vector<PieceStatsIndexEntry> index;                // Index of every block in the file (writer thread)
+};
+
+#endif
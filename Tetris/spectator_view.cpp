@@ -0,0 +1,187 @@
+// spectator_view.cpp
+
+#include <cmath>        // Include for the layout computation
+
+#include "spectator_view.h"  // Includes the SpectatorView class
+#include "game.h"       // Includes the Game class which handles the game logic
+#include "board.h"      // Includes the Board class which represents the game grid
+#include "piece.h"      // Includes the Piece class which represents the Tetris pieces
+#include "ai_player.h"  // Includes the AIPlayer class which plays the games
+
+// Packs a color into an ARGB8888 texel
+static Uint32 packColor(Uint8 r, Uint8 g, Uint8 b) {
+    return 0xFF000000u | (static_cast<Uint32>(r) << 16) | (static_cast<Uint32>(g) << 8) | b;
+}
+
+// Constructor: one headless game per board, each with its own seed, and a layout close to the window's shape
+SpectatorView::SpectatorView(int boardCount) {
+    if (boardCount < 1) boardCount = 1;
+
+    for (int i = 0; i < boardCount; ++i) {
+        Player player;
+        player.game = new Game(static_cast<Uint32>(i + 1) * 2654435761u);
+        player.ai = new AIPlayer(player.game);
+        player.nextGravity = 0;
+        player.nextAction = 0;
+        players.push_back(player);
+    }
+
+    Board* board = players[0].game->getBoard();
+    tileWidth = board->getWidth() + GUTTER;
+    tileHeight = board->getHeight() + GUTTER;
+
+    // Pick the number of columns that makes the texture's aspect ratio match the window's
+    double aspect = static_cast<double>(win_Width) / win_Height;
+    columns = static_cast<int>(std::ceil(std::sqrt(boardCount * aspect * tileHeight / tileWidth)));
+    if (columns > boardCount) columns = boardCount;
+    rows = (boardCount + columns - 1) / columns;
+}
+
+// Destructor: deletes the games and AI players
+SpectatorView::~SpectatorView() {
+    for (auto& player : players) {
+        delete player.ai;
+        delete player.game;
+    }
+}
+
+void SpectatorView::start() {
+    SDL_Init(SDL_INIT_VIDEO);  // Initialize SDL video subsystem
+
+    // Create the window, the renderer, and the texture holding every board
+    SDL_Window* window = SDL_CreateWindow("Tetris - Spectator", win_Width, win_Height, 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, NULL);
+    SDL_SetRenderVSync(renderer, 1);  // Pace presentation to the display refresh rate
+
+    int textureWidth = columns * tileWidth + GUTTER;
+    int textureHeight = rows * tileHeight + GUTTER;
+    SDL_Texture* texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, textureWidth, textureHeight);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);  // Keep cells sharp when stretched
+
+    // Stretch the texture over the window, keeping its aspect ratio
+    float scale = std::fmin(static_cast<float>(win_Width) / textureWidth, static_cast<float>(win_Height) / textureHeight);
+    SDL_FRect dest = {(win_Width - textureWidth * scale) / 2, (win_Height - textureHeight * scale) / 2, textureWidth * scale, textureHeight * scale};
+
+    // Stagger the AI players so they do not all act on the same frame
+    Uint64 now = SDL_GetTicks();
+    for (int i = 0; i < static_cast<int>(players.size()); ++i) {
+        players[i].nextAction = now + i % AI_ACTION_MS;
+        players[i].nextGravity = now + players[i].game->getSpeed();
+    }
+
+    bool run = true;
+    int frames = 0;
+    Uint64 fpsStart = now;
+    char title[128];
+
+    while (run) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {  // Poll all events
+            if (event.type == SDL_EVENT_QUIT || (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_ESCAPE)) {
+                run = false;
+            }
+        }
+
+        now = SDL_GetTicks();
+        stepPlayers(now);
+
+        // Upload every board at once
+        void* pixels;
+        int pitch;
+        if (SDL_LockTexture(texture, NULL, &pixels, &pitch)) {
+            drawBoards(static_cast<Uint32*>(pixels), pitch);
+            SDL_UnlockTexture(texture);
+        }
+
+        // The whole view is one clear and one textured quad
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        SDL_RenderTexture(renderer, texture, NULL, &dest);
+        SDL_RenderPresent(renderer);
+
+        // Show the frame rate in the window title once per second
+        frames++;
+        if (now - fpsStart >= 1000) {
+            SDL_snprintf(title, sizeof(title), "Tetris - Spectator - %d boards - %d FPS", static_cast<int>(players.size()), static_cast<int>(frames * 1000 / (now - fpsStart)));
+            SDL_SetWindowTitle(window, title);
+            frames = 0;
+            fpsStart = now;
+        }
+    }
+
+    // Clean up SDL resources
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+void SpectatorView::stepPlayers(Uint64 now) {
+    for (auto& player : players) {
+        Game* game = player.game;
+
+        // A finished game starts over right away
+        if (game->isGameOver()) {
+            game->resetGame();
+            player.nextGravity = now + game->getSpeed();
+        }
+
+        if (now >= player.nextAction) {
+            InputAction action;
+            if (player.ai->nextAction(action)) {
+                game->applyInput(action);
+            }
+            player.nextAction = now + AI_ACTION_MS;
+        }
+
+        if (now >= player.nextGravity) {
+            game->update();
+            player.nextGravity = now + game->getSpeed();
+        }
+    }
+}
+
+void SpectatorView::drawBoards(Uint32* pixels, int pitch) {
+    const Uint32 gutterColor = packColor(60, 60, 60);
+    const Uint32 emptyColor = packColor(12, 12, 12);
+    int stride = pitch / static_cast<int>(sizeof(Uint32));
+    int textureWidth = columns * tileWidth + GUTTER;
+    int textureHeight = rows * tileHeight + GUTTER;
+
+    // Start from the gutter color everywhere (also covers unused tiles)
+    for (int y = 0; y < textureHeight; ++y) {
+        Uint32* row = pixels + y * stride;
+        for (int x = 0; x < textureWidth; ++x) {
+            row[x] = gutterColor;
+        }
+    }
+
+    for (int i = 0; i < static_cast<int>(players.size()); ++i) {
+        Board* board = players[i].game->getBoard();
+        Piece* piece = players[i].game->getPiece();
+        int originX = (i % columns) * tileWidth + GUTTER;
+        int originY = (i / columns) * tileHeight + GUTTER;
+
+        // Board cells
+        for (int y = 0; y < board->getHeight(); ++y) {
+            Uint32* row = pixels + (originY + y) * stride + originX;
+            for (int x = 0; x < board->getWidth(); ++x) {
+                SDL_Color c = board->getCell(x, y);
+                row[x] = (c.r != 0 || c.g != 0 || c.b != 0) ? packColor(c.r, c.g, c.b) : emptyColor;
+            }
+        }
+
+        // Active piece
+        if (!players[i].game->isGameOver()) {
+            SDL_Color c = piece->getColor();
+            Uint32 pieceColor = packColor(c.r, c.g, c.b);
+            for (const auto& block : piece->getBlock()) {
+                int x = piece->getPieceX() + block.first;
+                int y = piece->getPieceY() + block.second;
+                if (board->isValid(x, y)) {
+                    pixels[(originY + y) * stride + originX + x] = pieceColor;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,52 @@
+// spectator_view.h
+
+#ifndef SPECTATOR_VIEW_H
+#define SPECTATOR_VIEW_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the window, renderer and texture
+#include <vector>       // Include vector for the list of players
+
+class Game;       // Forward declaration of Game class
+class AIPlayer;   // Forward declaration of AIPlayer class
+
+// SpectatorView shows many AI-driven games at once ("battle royale" view).
+// Instead of drawing every cell with its own SDL calls, every board is written into one streaming
+// texture (one texel per cell) that is stretched over the window, so a frame always costs the same
+// handful of draw calls no matter how many boards are shown
+class SpectatorView {
+public:
+    // Constructor: creates the headless games and their AI players
+    explicit SpectatorView(int boardCount);
+
+    // Destructor: deletes the games and AI players
+    ~SpectatorView();
+
+    // Opens the window and runs the view until it is closed
+    void start();
+
+private:
+    // One AI-driven board
+    struct Player {
+        Game* game;          // Headless game (no audio, no window)
+        AIPlayer* ai;        // AI steering the game's pieces
+        Uint64 nextGravity;  // Time (ms) of the next gravity step
+        Uint64 nextAction;   // Time (ms) of the next AI action
+    };
+
+    // Advances every game that is due at time 'now' (ms)
+    void stepPlayers(Uint64 now);
+
+    // Writes every board (cells, active piece, gutters) into the locked texture pixels
+    void drawBoards(Uint32* pixels, int pitch);
+
+    static const int AI_ACTION_MS = 40;   // Delay between two AI actions
+    static const int GUTTER = 1;          // Texels between two boards
+
+    std::vector<Player> players;   // All the boards shown
+    int columns, rows;             // Layout of the boards on screen
+    int tileWidth, tileHeight;     // Texels used by one board, gutter included
+    int win_Width = 1280;          // Window dimensions
+    int win_Height = 900;
+};
+
+#endif
@@ -0,0 +1,46 @@
+// spsc_queue.h
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>   // Include atomic for the lock-free head/tail indices
+
+// Bounded lock-free single-producer / single-consumer ring queue.
+// push() and pop() never block: push() fails when the queue is full, pop() fails when it is empty.
+// One slot is kept free to tell a full queue from an empty one, so it holds Capacity - 1 items.
+template <typename T, int Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side: appends a value; returns false (and drops it) if the queue is full
+    bool push(const T& value) {
+        int t = tail.load(std::memory_order_relaxed);
+        int next = (t + 1) % Capacity;
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;  // Queue is full
+        }
+        items[t] = value;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: removes the oldest value; returns false if the queue is empty
+    bool pop(T& value) {
+        int h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;  // Queue is empty
+        }
+        value = items[h];
+        head.store((h + 1) % Capacity, std::memory_order_release);
+        return true;
+    }
+
+private:
+    T items[Capacity];          // Ring storage
+    std::atomic<int> head;      // Next slot to read (written by the consumer only)
+    char padding[64];           // Keeps head and tail on separate cache lines
+    std::atomic<int> tail;      // Next slot to write (written by the producer only)
+};
+
+#endif
@@ -0,0 +1,160 @@
+// telemetry.cpp
+
+#include <cstring>      // Include for memcpy
+
+#include "telemetry.h"  // Includes the telemetry ring types
+
+#ifdef _WIN32
+#include <windows.h>    // Include for CreateFileMapping / MapViewOfFile
+#else
+#include <sys/mman.h>   // Include for shm_open / mmap
+#include <sys/stat.h>   // Include for the shm_open mode flags
+#include <fcntl.h>      // Include for O_CREAT / O_RDWR
+#include <unistd.h>     // Include for ftruncate / close
+#endif
+
+TelemetryMapping::TelemetryMapping() : head(nullptr), slots(nullptr), mappedSize(0), owner(false) {
+#ifdef _WIN32
+    handle = nullptr;
+#endif
+}
+
+TelemetryMapping::~TelemetryMapping() {
+    close();
+}
+
+bool TelemetryMapping::create(const std::string& name, Uint32 slotCount) {
+    if (slotCount == 0 || !map(name, sizeof(TelemetryHeader) + sizeof(TelemetrySlot) * slotCount, true)) {
+        return false;
+    }
+
+    // The block may be left over from an earlier run that readers still map: withdraw the magic number first so
+    // they stop trusting it, reset the header and the ring, then publish the magic number last
+    head->magic = 0;
+    std::atomic_thread_fence(std::memory_order_release);
+    head->version = TelemetryHeader::VERSION;
+    head->slotCount = slotCount;
+    head->recordSize = sizeof(TelemetryRecord);
+    head->published.store(0);
+    for (Uint32 i = 0; i < slotCount; ++i) {
+        slots[i].sequence.store(0);
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    head->magic = TelemetryHeader::MAGIC;
+    return true;
+}
+
+bool TelemetryMapping::open(const std::string& name) {
+    // Map the header first to learn the ring size, then map the whole block
+    if (!map(name, sizeof(TelemetryHeader), false)) {
+        return false;
+    }
+    Uint32 slotCount = head->slotCount;
+    bool valid = head->magic == TelemetryHeader::MAGIC && head->version == TelemetryHeader::VERSION &&
+                 head->recordSize == sizeof(TelemetryRecord) && slotCount > 0;
+    close();
+    return valid && map(name, sizeof(TelemetryHeader) + sizeof(TelemetrySlot) * slotCount, false);
+}
+
+bool TelemetryMapping::map(const std::string& name, size_t size, bool writer) {
+    close();
+    void* memory = nullptr;
+
+#ifdef _WIN32
+    shmName = "Local\\" + name;
+    if (writer) {
+        handle = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, static_cast<DWORD>(size), shmName.c_str());
+    } else {
+        handle = OpenFileMappingA(FILE_MAP_READ, FALSE, shmName.c_str());
+    }
+    if (!handle) {
+        return false;
+    }
+    memory = MapViewOfFile(handle, writer ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ, 0, 0, size);
+    if (!memory) {
+        CloseHandle(handle);
+        handle = nullptr;
+        return false;
+    }
+#else
+    shmName = "/" + name;
+    int fd = writer ? shm_open(shmName.c_str(), O_CREAT | O_RDWR, 0644) : shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    if (writer && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        ::close(fd);
+        return false;
+    }
+    memory = mmap(nullptr, size, writer ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping stays valid without the descriptor
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+#endif
+
+    head = static_cast<TelemetryHeader*>(memory);
+    slots = reinterpret_cast<TelemetrySlot*>(head + 1);
+    mappedSize = size;
+    owner = writer;
+    return true;
+}
+
+void TelemetryMapping::close() {
+    if (!head) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(head);
+    CloseHandle(handle);
+    handle = nullptr;
+#else
+    munmap(head, mappedSize);
+    if (owner) {
+        shm_unlink(shmName.c_str());  // Readers keep their mapping until they close it
+    }
+#endif
+    head = nullptr;
+    slots = nullptr;
+    mappedSize = 0;
+    owner = false;
+}
+
+bool TelemetryWriter::open(const std::string& name, Uint32 slotCount) {
+    return mapping.create(name, slotCount);
+}
+
+void TelemetryWriter::publish(const TelemetryRecord& record) {
+    TelemetryHeader* header = mapping.header();
+    Uint64 index = header->published.load(std::memory_order_relaxed);
+    TelemetrySlot* slot = mapping.slot(index);
+
+    // Mark the slot as being written (odd), fill it, then mark it complete for this index
+    slot->sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot->record, &record, sizeof(record));
+    slot->sequence.store(2 * (index + 1), std::memory_order_release);
+
+    header->published.store(index + 1, std::memory_order_release);
+}
+
+bool TelemetryReader::open(const std::string& name) {
+    return mapping.open(name);
+}
+
+Uint64 TelemetryReader::published() const {
+    return mapping.header()->published.load(std::memory_order_acquire);
+}
+
+bool TelemetryReader::read(Uint64 index, TelemetryRecord& record) const {
+    const TelemetrySlot* slot = mapping.slot(index);
+    Uint64 expected = 2 * (index + 1);
+
+    // Copy the slot, then check that the writer neither touched it meanwhile nor moved on to a newer record
+    if (slot->sequence.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    std::memcpy(&record, &slot->record, sizeof(record));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->sequence.load(std::memory_order_relaxed) == expected;
+}
@@ -0,0 +1,115 @@
+// telemetry.h
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the fixed-size integer types
+#include <atomic>       // Include atomic for the slot sequence numbers shared with readers
+#include <string>       // Include string for the shared memory name
+
+// Per-tick state published to shared memory for external overlays, loggers and analyzers.
+// Everything is fixed size so the layout is the same in every process
+struct TelemetryRecord {
+    static const int MAX_HEIGHT = 32;  // Rows of occupancy a record can hold
+    static const int MAX_INPUTS = 15;  // Input events a record can hold for one tick
+
+    Uint64 tick;                  // Simulation tick number
+    Uint64 timeNS;                // SDL_GetTicksNS() when the tick ran
+    Sint32 score;                 // Current score
+    Sint32 speed;                 // Gravity delay in ms, from Game::updateSpeed
+    Sint32 linesCleared;          // Total lines cleared
+    Sint32 piecesSpawned;         // Pieces spawned since the last reset
+    Uint8 width, height;          // Board dimensions
+    Uint8 pieceType;              // Type of the active piece (PieceType order)
+    Uint8 gameOver;               // 1 once the game is over
+    Sint8 pieceX, pieceY;         // Position of the active piece
+    Sint8 pieceBlocks[4][2];      // Board (x, y) of each block of the active piece
+    Uint8 inputCount;             // Number of valid entries in inputs
+    Uint8 inputs[MAX_INPUTS];     // InputActions applied during this tick, in order
+    Uint16 occupancy[MAX_HEIGHT]; // One bit per filled cell, bit x of row y
+};
+
+// One entry of the ring, guarded by a sequence lock: the sequence is odd while the writer fills the slot,
+// and equals 2 * (index + 1) once record number 'index' is complete
+struct TelemetrySlot {
+    std::atomic<Uint64> sequence;
+    TelemetryRecord record;
+};
+
+// Start of the shared memory block, followed by slotCount slots
+struct TelemetryHeader {
+    static const Uint32 MAGIC = 0x544c4d54;  // "TMLT"
+    static const Uint32 VERSION = 1;
+
+    Uint32 magic;                    // MAGIC once the block is initialized
+    Uint32 version;                  // VERSION of the layout
+    Uint32 slotCount;                // Number of slots in the ring
+    Uint32 recordSize;               // sizeof(TelemetryRecord), to catch mismatched builds
+    std::atomic<Uint64> published;   // Number of records published so far
+};
+
+// Maps the telemetry block of a given name; used by the game (writer) and by readers
+class TelemetryMapping {
+public:
+    TelemetryMapping();
+    ~TelemetryMapping();
+
+    // Creates (writer) or opens (reader) the shared memory block; returns false on failure
+    bool create(const std::string& name, Uint32 slotCount);
+    bool open(const std::string& name);
+
+    // Unmaps the block (and removes the name if this mapping created it)
+    void close();
+
+    TelemetryHeader* header() const { return head; }
+    TelemetrySlot* slot(Uint64 index) const { return slots + index % head->slotCount; }
+
+private:
+    bool map(const std::string& name, size_t size, bool writer);
+
+    TelemetryHeader* head;   // Mapped header
+    TelemetrySlot* slots;    // Mapped ring
+    size_t mappedSize;       // Size of the mapping in bytes
+    std::string shmName;     // Platform name of the block
+    bool owner;              // True if this mapping created the block
+#ifdef _WIN32
+    void* handle;            // File mapping handle
+#endif
+};
+
+// Writes records into the ring. Never waits for readers: a slow reader just sees its records overwritten
+class TelemetryWriter {
+public:
+    // Creates the shared memory block; returns false on failure
+    bool open(const std::string& name, Uint32 slotCount = 1024);
+
+    // Checks if the writer has a block to publish into
+    bool isOpen() const { return mapping.header() != nullptr; }
+
+    // Publishes one record
+    void publish(const TelemetryRecord& record);
+
+private:
+    TelemetryMapping mapping;
+};
+
+// Reads records from the ring without ever blocking the writer
+class TelemetryReader {
+public:
+    // Opens an existing shared memory block; returns false if there is none (yet)
+    bool open(const std::string& name);
+
+    // Number of records published so far
+    Uint64 published() const;
+
+    // Number of slots in the ring: records older than published() - slotCount() are gone
+    Uint32 slotCount() const { return mapping.header()->slotCount; }
+
+    // Copies record number 'index'; returns false if the slot was being written or already reused
+    bool read(Uint64 index, TelemetryRecord& record) const;
+
+private:
+    TelemetryMapping mapping;
+};
+
+#endif
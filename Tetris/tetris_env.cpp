@@ -0,0 +1,155 @@
+// tetris_env.cpp
+
+#include <cstddef>      // Include for offsetof
+#include <vector>       // Include vector for the list of games
+
+#include "tetris_env.h" // Includes the C interface implemented here
+#include "game.h"       // Includes the Game class which handles the game logic
+#include "board.h"      // Includes the Board class which represents the game grid
+#include "piece.h"      // Includes the Piece class which represents the Tetris pieces
+#include "alloc_tracker.h" // Includes the allocation counters (opt-in)
+
+// The observation layout is part of the ABI: catch any accidental change at compile time
+static_assert(sizeof(TetrisObservation) == 232, "TetrisObservation layout changed: bump TETRIS_ENV_ABI_VERSION");
+static_assert(offsetof(TetrisObservation, piece_blocks) == 200, "TetrisObservation layout changed");
+static_assert(offsetof(TetrisObservation, piece_x) == 216, "TetrisObservation layout changed");
+static_assert(offsetof(TetrisObservation, score) == 220, "TetrisObservation layout changed");
+static_assert(Game::QUEUE_SIZE >= TETRIS_ENV_QUEUE, "Game does not know enough upcoming pieces");
+
+// A set of headless games
+struct TetrisEnv {
+    std::vector<Game*> games;
+};
+
+// Writes the observation of a game into the caller's buffer
+static void writeObservation(Game* game, TetrisObservation* obs) {
+    Board* board = game->getBoard();
+    Piece* piece = game->getPiece();
+
+    for (int y = 0; y < TETRIS_ENV_HEIGHT; ++y) {
+        for (int x = 0; x < TETRIS_ENV_WIDTH; ++x) {
+            obs->grid[y][x] = board->isCellEmpty(x, y) ? 0 : 1;
+        }
+    }
+
+    const std::vector<std::pair<int, int>>& blocks = piece->getBlock();
+    for (int i = 0; i < 4; ++i) {
+        obs->piece_blocks[i][0] = static_cast<int8_t>(piece->getPieceX() + blocks[i].first);
+        obs->piece_blocks[i][1] = static_cast<int8_t>(piece->getPieceY() + blocks[i].second);
+    }
+    obs->piece_type = static_cast<uint8_t>(piece->getType());
+    for (int i = 0; i < TETRIS_ENV_QUEUE; ++i) {
+        obs->queue[i] = static_cast<uint8_t>(game->getNextPiece(i));
+    }
+    obs->game_over = game->isGameOver() ? 1 : 0;
+    obs->reserved = 0;
+    obs->piece_x = static_cast<int16_t>(piece->getPieceX());
+    obs->piece_y = static_cast<int16_t>(piece->getPieceY());
+    obs->score = game->getScore();
+    obs->lines = board->getLinesCleared();
+    obs->pieces = game->getPiecesSpawned();
+}
+
+// Applies one action and one gravity step to a game
+static void stepGame(Game* game, int action, TetrisObservation* obs, int32_t* reward, uint8_t* done) {
+    AllocScope scope(AllocSubsystem::Simulation);
+    int scoreBefore = game->getScore();
+
+    if (!game->isGameOver()) {
+        switch (action) {
+            case TETRIS_ACTION_LEFT: game->applyInput(InputAction::MoveLeft); break;
+            case TETRIS_ACTION_RIGHT: game->applyInput(InputAction::MoveRight); break;
+            case TETRIS_ACTION_DOWN: game->applyInput(InputAction::MoveDown); break;
+            case TETRIS_ACTION_ROTATE: game->applyInput(InputAction::Rotate); break;
+            default: break;
+        }
+        game->update();  // Gravity
+    }
+
+    if (obs) writeObservation(game, obs);
+    if (reward) *reward = game->getScore() - scoreBefore;
+    if (done) *done = game->isGameOver() ? 1 : 0;
+}
+
+TetrisEnv* tetris_env_create(int count) {
+    if (count < 1) {
+        return nullptr;
+    }
+    TetrisEnv* env = new TetrisEnv();
+    env->games.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        env->games.push_back(new Game(static_cast<Uint32>(i + 1)));
+    }
+    return env;
+}
+
+void tetris_env_destroy(TetrisEnv* env) {
+    if (!env) {
+        return;
+    }
+    for (Game* game : env->games) {
+        delete game;
+    }
+    delete env;
+}
+
+int tetris_env_count(const TetrisEnv* env) {
+    return env ? static_cast<int>(env->games.size()) : 0;
+}
+
+int tetris_env_abi_version(void) {
+    return TETRIS_ENV_ABI_VERSION;
+}
+
+// Checks an environment index against the set (the caller may be Python, so nothing is assumed)
+static int checkIndex(const TetrisEnv* env, int index) {
+    if (!env) {
+        return TETRIS_ENV_ERROR_NULL;
+    }
+    return index >= 0 && index < static_cast<int>(env->games.size()) ? TETRIS_ENV_OK : TETRIS_ENV_ERROR_INDEX;
+}
+
+int tetris_env_reset(TetrisEnv* env, int index, uint32_t seed, TetrisObservation* obs) {
+    int error = checkIndex(env, index);
+    if (error != TETRIS_ENV_OK) {
+        return error;
+    }
+    AllocScope scope(AllocSubsystem::Simulation);
+    Game* game = env->games[index];
+    game->resetGame(seed);
+    if (obs) writeObservation(game, obs);
+    return TETRIS_ENV_OK;
+}
+
+int tetris_env_step(TetrisEnv* env, int index, int action, TetrisObservation* obs, int32_t* reward, uint8_t* done) {
+    int error = checkIndex(env, index);
+    if (error != TETRIS_ENV_OK) {
+        return error;
+    }
+    if (action < 0 || action >= TETRIS_ACTION_COUNT) {
+        return TETRIS_ENV_ERROR_ACTION;
+    }
+    stepGame(env->games[index], action, obs, reward, done);
+    return TETRIS_ENV_OK;
+}
+
+int tetris_env_step_many(TetrisEnv* env, int first, int count, const uint8_t* actions,
+                         TetrisObservation* obs, int32_t* rewards, uint8_t* dones) {
+    if (!env || (!actions && count > 0)) {
+        return TETRIS_ENV_ERROR_NULL;
+    }
+    // The range is checked without computing first + count, which could overflow
+    int total = static_cast<int>(env->games.size());
+    if (count < 0 || first < 0 || first > total || count > total - first) {
+        return TETRIS_ENV_ERROR_INDEX;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (actions[i] >= TETRIS_ACTION_COUNT) {
+            return TETRIS_ENV_ERROR_ACTION;
+        }
+    }
+    for (int i = 0; i < count; ++i) {
+        stepGame(env->games[first + i], actions[i], obs ? obs + i : nullptr, rewards ? rewards + i : nullptr, dones ? dones + i : nullptr);
+    }
+    return TETRIS_ENV_OK;
+}
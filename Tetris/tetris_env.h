@@ -0,0 +1,97 @@
+/* tetris_env.h */
+
+#ifndef TETRIS_ENV_H
+#define TETRIS_ENV_H
+
+/* C interface to headless games, for reinforcement-learning environments.
+   Observations are written straight into buffers owned by the caller (plain memory or a shared-memory
+   mapping) with the fixed layout below; stepping never allocates or serializes anything.
+   Different environment indices may be stepped from different threads at the same time. */
+
+#include <stdint.h>   /* Include for fixed-size integer types */
+
+#ifdef _WIN32
+#define TETRIS_ENV_API __declspec(dllexport)
+#else
+#define TETRIS_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TETRIS_ENV_ABI_VERSION 1   /* Bumped whenever the layout of TetrisObservation changes */
+#define TETRIS_ENV_WIDTH 10        /* Board width in cells */
+#define TETRIS_ENV_HEIGHT 20       /* Board height in cells */
+#define TETRIS_ENV_QUEUE 5         /* Number of upcoming pieces in an observation */
+
+/* Actions accepted by tetris_env_step: one action is applied, then gravity moves the piece one row */
+enum {
+    TETRIS_ACTION_NONE = 0,
+    TETRIS_ACTION_LEFT = 1,
+    TETRIS_ACTION_RIGHT = 2,
+    TETRIS_ACTION_DOWN = 3,
+    TETRIS_ACTION_ROTATE = 4,
+    TETRIS_ACTION_COUNT = 5
+};
+
+/* Returned by tetris_env_reset, tetris_env_step and tetris_env_step_many. On an error nothing is stepped
+   or reset and no output is written */
+enum {
+    TETRIS_ENV_OK = 0,
+    TETRIS_ENV_ERROR_NULL = -1,     /* env (or actions for step_many) is NULL */
+    TETRIS_ENV_ERROR_INDEX = -2,    /* An environment index is outside 0 .. tetris_env_count() - 1, or count < 0 */
+    TETRIS_ENV_ERROR_ACTION = -3    /* An action is outside 0 .. TETRIS_ACTION_COUNT - 1 */
+};
+
+/* Piece types use the order of PieceType: I, O, T, L, J, S, Z = 0..6 */
+
+/* Observation of one environment: 232 bytes, no padding, every field naturally aligned */
+typedef struct TetrisObservation {
+    uint8_t grid[TETRIS_ENV_HEIGHT][TETRIS_ENV_WIDTH]; /* Locked cells, row 0 at the top: 0 = empty, 1 = filled (offset 0) */
+    int8_t piece_blocks[4][2];                          /* Board (x, y) of each block of the active piece (offset 200) */
+    uint8_t piece_type;                                 /* Type of the active piece (offset 208) */
+    uint8_t queue[TETRIS_ENV_QUEUE];                    /* Upcoming piece types, next one first (offset 209) */
+    uint8_t game_over;                                  /* 1 once the game is over (offset 214) */
+    uint8_t reserved;                                   /* Always 0 (offset 215) */
+    int16_t piece_x, piece_y;                           /* Position of the active piece (offset 216) */
+    int32_t score;                                      /* Score, as awarded by Board::clearFullLines (offset 220) */
+    int32_t lines;                                      /* Total lines cleared (offset 224) */
+    int32_t pieces;                                     /* Pieces spawned since the last reset (offset 228) */
+} TetrisObservation;
+
+typedef struct TetrisEnv TetrisEnv;  /* Opaque set of environments */
+
+/* Creates 'count' environments; returns NULL if count < 1 */
+TETRIS_ENV_API TetrisEnv* tetris_env_create(int count);
+
+/* Destroys the environments */
+TETRIS_ENV_API void tetris_env_destroy(TetrisEnv* env);
+
+/* Returns the number of environments */
+TETRIS_ENV_API int tetris_env_count(const TetrisEnv* env);
+
+/* Returns TETRIS_ENV_ABI_VERSION of the library, to check against the header in use */
+TETRIS_ENV_API int tetris_env_abi_version(void);
+
+/* Starts a new game in environment 'index'; the same seed always gives the same piece sequence.
+   Writes the first observation into 'obs' (may be NULL). Returns TETRIS_ENV_OK or an error code */
+TETRIS_ENV_API int tetris_env_reset(TetrisEnv* env, int index, uint32_t seed, TetrisObservation* obs);
+
+/* Applies one action to environment 'index', then one gravity step.
+   Writes the observation, the reward (score gained) and the game over flag; any pointer may be NULL.
+   A finished environment ignores actions until it is reset. Returns TETRIS_ENV_OK or an error code */
+TETRIS_ENV_API int tetris_env_step(TetrisEnv* env, int index, int action, TetrisObservation* obs, int32_t* reward, uint8_t* done);
+
+/* Steps environments first .. first + count - 1 with actions[0 .. count - 1].
+   obs, rewards and dones are arrays of 'count' elements (each may be NULL).
+   Callers can split the environments into disjoint ranges and step them from several threads.
+   Every index and action is checked before any environment is stepped. Returns TETRIS_ENV_OK or an error code */
+TETRIS_ENV_API int tetris_env_step_many(TetrisEnv* env, int first, int count, const uint8_t* actions,
+                                        TetrisObservation* obs, int32_t* rewards, uint8_t* dones);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
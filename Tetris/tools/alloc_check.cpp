@@ -0,0 +1,154 @@
+// alloc_check.cpp
+//
+// Checks that gameplay does not touch the heap once it is running. After a warm-up, it counts every
+// allocation (operator new and SDL's allocator) made by:
+//   - the simulation tick, fed with keyboard events through the render thread's input queue,
+//   - the C interface for training (tetris_env_step_many, with resets when a game ends),
+//   - the render path (snapshot, board, piece and text), on an offscreen window when one can be created.
+// Exits with 1 and lists the subsystems that allocated if any of them did.
+//   alloc_check [ticks]
+//
+// Build: compile with TETRIS_TRACK_ALLOCATIONS defined, together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -DTETRIS_TRACK_ALLOCATIONS -I. tools/alloc_check.cpp tetris_env.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "game.h"
+#include "alloc_tracker.h"
+#include "tetris_env.h"
+
+static const int WARMUP_TICKS = 2000;  // Ticks run before counting: first frames, first game over and reset
+static const int ENVIRONMENTS = 8;     // Games stepped together through the C interface
+
+// xorshift32, so the run is the same every time
+static Uint32 nextRandom(Uint32& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// Sends one key press the way the render thread does, picking mostly soft drops so games end quickly
+static void pressRandomKey(Game& game, Uint32& rng) {
+    static const SDL_Keycode keys[] = {SDLK_A, SDLK_D, SDLK_W, SDLK_S, SDLK_S, SDLK_S};
+    SDL_Event event;
+    SDL_zero(event);
+    event.type = SDL_EVENT_KEY_DOWN;
+    event.key.key = game.isGameOver() ? SDLK_R : keys[nextRandom(rng) % 6];
+    game.processEvent(event);
+}
+
+// Reports the allocations of one check; returns true if there were none
+static bool report(const char* check, int ticks, const AllocCounters& before, const AllocCounters& after) {
+    Uint64 total = AllocTracker::allocationsBetween(before, after);
+    std::printf("%-12s %7d ticks: %llu allocations\n", check, ticks, static_cast<unsigned long long>(total));
+    for (int i = 0; i < static_cast<int>(AllocSubsystem::Count); ++i) {
+        Uint64 count = after.allocations[i] - before.allocations[i];
+        if (count > 0) {
+            std::printf("  %-10s %llu allocations, %llu bytes\n", AllocTracker::name(static_cast<AllocSubsystem>(i)),
+                        static_cast<unsigned long long>(count), static_cast<unsigned long long>(after.bytes[i] - before.bytes[i]));
+        }
+    }
+    return total == 0;
+}
+
+// Simulation ticks with a simulated clock: 50 ms per tick, so gravity runs every few ticks
+static void runTicks(Game& game, Uint32& rng, Uint64& now, int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        pressRandomKey(game, rng);
+        now += 50;
+        game.simulationTick(now);
+    }
+}
+
+// Steps every environment with random actions and resets the games that end
+static void runEnvironments(TetrisEnv* env, Uint32& rng, int ticks, uint8_t* actions, uint8_t* dones, Uint32& seed) {
+    for (int i = 0; i < ticks; ++i) {
+        for (int e = 0; e < ENVIRONMENTS; ++e) {
+            actions[e] = static_cast<uint8_t>(nextRandom(rng) % 5);
+        }
+        tetris_env_step_many(env, 0, ENVIRONMENTS, actions, nullptr, nullptr, dones);
+        for (int e = 0; e < ENVIRONMENTS; ++e) {
+            if (dones[e]) {
+                tetris_env_reset(env, e, seed++, nullptr);
+            }
+        }
+    }
+}
+
+// Draws frames the way the render loop does, from snapshots taken after each tick
+static void runFrames(Game& game, SDL_Renderer* renderer, FrameSnapshot& frame, Uint32& rng, Uint64& now, int ticks) {
+    for (int i = 0; i < ticks; ++i) {
+        runTicks(game, rng, now, 1);
+        game.fillSnapshot(frame);
+        AllocScope scope(AllocSubsystem::Render);
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        game.render(renderer, frame);
+        SDL_RenderPresent(renderer);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int ticks = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (!AllocTracker::enabled()) {
+        std::printf("alloc_check must be built with TETRIS_TRACK_ALLOCATIONS defined\n");
+        return 1;
+    }
+    AllocTracker::install();
+
+    bool clean = true;
+    AllocCounters before, after;
+    Uint32 rng = 2463534242u;
+
+    // Simulation thread path: input queue, ticks, game over animation, resets, frame publishing
+    Game game(1);
+    Uint64 now = 0;
+    runTicks(game, rng, now, WARMUP_TICKS);
+    AllocTracker::snapshot(before);
+    runTicks(game, rng, now, ticks);
+    AllocTracker::snapshot(after);
+    clean = report("simulation", ticks, before, after) && clean;
+
+    // C interface for training
+    TetrisEnv* env = tetris_env_create(ENVIRONMENTS);
+    uint8_t actions[ENVIRONMENTS], dones[ENVIRONMENTS];
+    Uint32 seed = 100;
+    runEnvironments(env, rng, WARMUP_TICKS, actions, dones, seed);
+    AllocTracker::snapshot(before);
+    runEnvironments(env, rng, ticks, actions, dones, seed);
+    AllocTracker::snapshot(after);
+    clean = report("tetris_env", ticks, before, after) && clean;
+    tetris_env_destroy(env);
+
+    // Render path, when an offscreen window is available
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (SDL_Init(SDL_INIT_VIDEO) && TTF_Init()) {
+        window = SDL_CreateWindow("alloc_check", 800, 800, 0);
+        renderer = window ? SDL_CreateRenderer(window, "software") : nullptr;
+    }
+    if (renderer) {
+        FrameSnapshot frame;
+        game.prepareText(renderer);
+        runFrames(game, renderer, frame, rng, now, WARMUP_TICKS);
+        AllocTracker::snapshot(before);
+        runFrames(game, renderer, frame, rng, now, ticks);
+        AllocTracker::snapshot(after);
+        clean = report("render", ticks, before, after) && clean;
+        game.clearTextCache();
+        SDL_DestroyRenderer(renderer);
+    } else {
+        std::printf("render: skipped (no offscreen renderer: %s)\n", SDL_GetError());
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    TTF_Quit();
+    SDL_Quit();
+
+    std::printf(clean ? "no allocations after warm-up\n" : "FAILED: allocations after warm-up\n");
+    return clean ? 0 : 1;
+}
@@ -0,0 +1,206 @@
+// board_bench.cpp
+//
+// "Marathon" configuration: a very tall board (thousands of rows) with a deep stack, where 1 to 4 lines are
+// cleared at a time and garbage keeps coming in from the bottom (as in a versus game). The clears happen near
+// the top of the stack, in its middle and near its bottom, since the cost of a clear depends on where it is.
+// Compares Board's ring of row indices with the previous row-copying storage, kept here as LegacyBoard,
+// after first checking that both hold the same cells after every operation of a shorter run.
+//   board_bench [height] [stack rows] [operations]
+//
+// Build: compile together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -I. tools/board_bench.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "board.h"
+
+// The previous storage: a vector of rows, every row above a cleared line copied down cell by cell
+class LegacyBoard {
+public:
+    LegacyBoard(int width, int height) : width(width), height(height), grid(height, std::vector<SDL_Color>(width, SDL_Color{0, 0, 0, 0})) {}
+
+    void setCell(int x, int y, SDL_Color color) { grid[y][x] = color; }
+    SDL_Color getCell(int x, int y) const { return grid[y][x]; }
+
+    bool isFullLine(int y) const {
+        for (int x = 0; x < width; x++) {
+            if (grid[y][x].r == 0 && grid[y][x].g == 0 && grid[y][x].b == 0) return false;
+        }
+        return true;
+    }
+
+    int clearFullLines() {
+        int lines = 0;
+        for (int y = height - 1; y >= 0; y--) {
+            if (isFullLine(y)) {
+                lines++;
+                for (int row = y; row > 0; row--) {
+                    for (int x = 0; x < width; x++) {
+                        grid[row][x] = grid[row - 1][x];
+                    }
+                }
+                for (int x = 0; x < width; x++) {
+                    grid[0][x] = {0, 0, 0, 0};
+                }
+                y++;
+            }
+        }
+        return lines;
+    }
+
+    void insertGarbageLines(int count, int holeX) {
+        for (int i = 0; i < count; ++i) {
+            for (int row = 0; row < height - 1; row++) {
+                for (int x = 0; x < width; x++) {
+                    grid[row][x] = grid[row + 1][x];
+                }
+            }
+            for (int x = 0; x < width; x++) {
+                grid[height - 1][x] = x == holeX ? SDL_Color{0, 0, 0, 0} : SDL_Color{128, 128, 128, 255};
+            }
+        }
+    }
+
+private:
+    int width, height;
+    std::vector<std::vector<SDL_Color>> grid;
+};
+
+// Board and LegacyBoard driven together: every operation goes to both, and after each one the line counts
+// and every cell must match
+class CheckedBoard {
+public:
+    CheckedBoard(int width, int height) : board(nullptr, nullptr, nullptr, width, height), legacy(width, height), width(width), height(height), mismatches(0) {}
+
+    void setCell(int x, int y, SDL_Color color) {
+        board.setCell(x, y, color);
+        legacy.setCell(x, y, color);
+    }
+
+    int clearFullLines() {
+        int lines = board.clearFullLines();
+        if (lines != legacy.clearFullLines()) mismatches++;
+        compare();
+        return lines;
+    }
+
+    void insertGarbageLines(int count, int holeX) {
+        board.insertGarbageLines(count, holeX);
+        legacy.insertGarbageLines(count, holeX);
+        compare();
+    }
+
+    int getMismatches() const { return mismatches; }
+
+private:
+    void compare() {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                SDL_Color a = board.getCell(x, y), b = legacy.getCell(x, y);
+                if (a.r != b.r || a.g != b.g || a.b != b.b) {
+                    mismatches++;
+                    return;
+                }
+            }
+        }
+    }
+
+    Board board;
+    LegacyBoard legacy;
+    int width, height;
+    int mismatches;  // Operations after which the two boards differed
+};
+
+// Runs the marathon workload on either storage and returns the time taken in milliseconds.
+// Each operation completes 1 to 4 rows starting 'depth' rows below the top of the stack and clears them; every
+// fourth operation two garbage rows come in from the bottom. The stack is topped up so its height stays about constant
+template <typename B>
+static double runMarathon(B& board, int width, int height, int stackRows, int depth, int operations, int& linesCleared) {
+    const SDL_Color color = {0, 200, 0, 255};
+
+    // Build the stack: every row has one hole, at a column that depends on the row
+    for (int y = height - stackRows; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (x != y % width) board.setCell(x, y, color);
+        }
+    }
+
+    int top = height - stackRows;  // Top row of the stack
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < operations; ++i) {
+        // Complete 1 to 4 rows of the stack (all below its top row, so the stack stays in one piece)
+        int count = 1 + i % 4;
+        int first = top + depth;
+        if (first + count > height) first = height - count;
+        for (int y = first; y < first + count; ++y) {
+            for (int x = 0; x < width; ++x) {
+                board.setCell(x, y, color);
+            }
+        }
+        linesCleared += board.clearFullLines();
+        top += count;
+
+        if (i % 4 == 3) {
+            // Two garbage rows push the stack back up
+            board.insertGarbageLines(2, i % width);
+            top -= 2;
+        }
+
+        // Keep the stack height constant by refilling the rows that appeared on top
+        while (top > height - stackRows) {
+            top--;
+            for (int x = 0; x < width; ++x) {
+                if (x != top % width) board.setCell(x, top, color);
+            }
+        }
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+    int height = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int stackRows = argc > 2 ? std::atoi(argv[2]) : height / 2;
+    int operations = argc > 3 ? std::atoi(argv[3]) : 2000;
+    const int width = 10;
+    if (stackRows > height - 4) stackRows = height - 4;
+    if (stackRows < 6) stackRows = 6;
+
+    // Where the cleared rows are, from the top of the stack
+    const char* const names[3] = {"near the top", "in the middle", "near the bottom"};
+    const int depths[3] = {1, stackRows / 2, stackRows - 4};
+
+    // Correctness first: a shorter run on both storages side by side, comparing every cell after every operation
+    int failures = 0;
+    for (int d = 0; d < 3; ++d) {
+        CheckedBoard checked(width, height);
+        int lines = 0;
+        runMarathon(checked, width, height, stackRows, depths[d], operations < 400 ? operations : 400, lines);
+        if (checked.getMismatches() > 0) {
+            std::printf("MISMATCH clearing %s: the boards differed after %d operations\n", names[d], checked.getMismatches());
+            failures++;
+        }
+    }
+
+    std::printf("marathon board %dx%d, stack of %d rows, %d operations (1 to 4 lines per clear, %d garbage rows)\n",
+                width, height, stackRows, operations, operations / 4 * 2);
+    for (int d = 0; d < 3; ++d) {
+        int ringLines = 0, legacyLines = 0;
+        Board board(nullptr, nullptr, nullptr, width, height);
+        double ringMs = runMarathon(board, width, height, stackRows, depths[d], operations, ringLines);
+
+        LegacyBoard legacy(width, height);
+        double legacyMs = runMarathon(legacy, width, height, stackRows, depths[d], operations, legacyLines);
+
+        std::printf("clearing %s (%d rows down the stack), %d lines cleared\n", names[d], depths[d], ringLines);
+        std::printf("  ring of row indices: %10.3f ms  (%8.2f us per operation)\n", ringMs, ringMs * 1000 / operations);
+        std::printf("  row copying        : %10.3f ms  (%8.2f us per operation)\n", legacyMs, legacyMs * 1000 / operations);
+        if (ringLines != legacyLines) {
+            std::printf("  MISMATCH: %d vs %d lines cleared\n", ringLines, legacyLines);
+            failures++;
+        }
+    }
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+// pc_bench.cpp
+//
+// Runs the perfect clear solver on empty boards with seeded piece sequences and reports solutions, fields
+// visited, solutions per second and wall time. Every solution kept is replayed on a fresh board to check
+// that each piece rests where it was placed and that the board ends up empty.
+//   pc_bench [threads] [rows] [pieces] [boards] [budget ms]
+//
+// Build: compile together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -I. tools/pc_bench.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "game.h"
+#include "board.h"
+#include "piece.h"
+#include "perfect_clear.h"
+
+// Places the pieces of a solution one after the other; returns false if one overlaps, floats or the board is not empty at the end
+static bool replay(const std::vector<PerfectClearPlacement>& solution, int width, int height) {
+    Board board(nullptr, nullptr, nullptr, width, height);
+    SDL_Color filled = {128, 128, 128, 255};
+    for (const PerfectClearPlacement& placement : solution) {
+        bool rests = false;
+        for (int k = 0; k < 4; ++k) {
+            int x = placement.blocks[k][0], y = placement.blocks[k][1];
+            if (!board.isValid(x, y) || !board.isCellEmpty(x, y)) {
+                return false;
+            }
+            rests = rests || y + 1 == height || !board.isCellEmpty(x, y + 1);
+        }
+        if (!rests) {
+            return false;
+        }
+        for (int k = 0; k < 4; ++k) {
+            board.setCell(placement.blocks[k][0], placement.blocks[k][1], filled);
+        }
+        board.clearFullLines();
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            if (!board.isCellEmpty(x, y)) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    int rows = argc > 2 ? std::atoi(argv[2]) : 4;
+    int pieces = argc > 3 ? std::atoi(argv[3]) : 10;
+    int boards = argc > 4 ? std::atoi(argv[4]) : 20;
+    Uint32 budgetMs = argc > 5 ? static_cast<Uint32>(std::atoi(argv[5])) : 1000;
+
+    PerfectClearSolver solver(threads);
+    Uint64 solutions = 0, nodes = 0;
+    double wallMs = 0;
+    int cleared = 0, timedOut = 0, invalid = 0;
+
+    for (int i = 0; i < boards; ++i) {
+        // The game's own generator gives the active piece and the sequence behind it
+        Game game(static_cast<Uint32>(i + 1));
+        std::vector<PieceType> queue;
+        for (int p = 1; p < pieces; ++p) {
+            queue.push_back(game.randomPieceType());
+        }
+
+        PerfectClearResult result = solver.solve(game.getBoard(), *game.getPiece(), queue, rows, budgetMs);
+        for (const auto& solution : result.solutions) {
+            invalid += !replay(solution, game.getBoard()->getWidth(), game.getBoard()->getHeight());
+        }
+        std::printf("board %3d: %8llu solutions %11llu fields %9.2f ms %10.0f solutions/s%s\n", i + 1,
+                    static_cast<unsigned long long>(result.solutionCount), static_cast<unsigned long long>(result.nodes),
+                    result.wallTimeMs, result.solutionsPerSecond, result.complete ? "" : "  (time budget reached)");
+
+        solutions += result.solutionCount;
+        nodes += result.nodes;
+        wallMs += result.wallTimeMs;
+        cleared += result.solutionCount > 0;
+        timedOut += !result.complete;
+    }
+
+    std::printf("%d threads, %d rows, %d pieces: %d/%d boards with a perfect clear, %d over budget\n",
+                solver.threadCount(), rows, pieces, cleared, boards, timedOut);
+    std::printf("  %llu solutions, %llu fields in %.1f ms (%.0f solutions/s, %.0f fields/s)\n",
+                static_cast<unsigned long long>(solutions), static_cast<unsigned long long>(nodes), wallMs,
+                wallMs > 0 ? solutions * 1000.0 / wallMs : 0.0, wallMs > 0 ? nodes * 1000.0 / wallMs : 0.0);
+    if (invalid) {
+        std::printf("  INVALID: %d solutions do not replay to an empty board\n", invalid);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,267 @@
+// stats_query.cpp
+//
+// Queries a per-piece statistics file (written by "Testris_graphic.exe --stats") without re-simulating anything.
+// The file is memory-mapped, blocks whose index ranges cannot match the filters are skipped, and only the
+// columns a query uses are decoded.
+//   stats_query <file>                                         summary: rows, games, size of each column
+//   stats_query <file> count|sum|avg|min|max [column] [filters] aggregate over the pieces matching every filter
+//   stats_query --record <file> [games] [pieces per game] [seed]  plays AI games and appends their pieces
+// Filters are column=value, column<value or column>value (quote them in the shell); the type column also takes
+// piece letters. For example, the average holes after S pieces at speed 100:
+//   stats_query piece_stats.pst avg holes type=S speed=100
+//
+// Build: compile together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -I. tools/stats_query.cpp ai_player.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "game.h"
+#include "ai_player.h"
+#include "piece_stats.h"
+
+static const char* const PIECE_LETTERS = "IOTLJSZ";  // PieceType order
+
+// A condition on one column
+struct Filter {
+    int column;
+    char op;       // '=', '<' or '>'
+    Sint32 value;
+};
+
+static int findColumn(const std::string& name) {
+    for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+        if (name == pieceStatsColumnName(static_cast<PieceStatsColumn>(c))) {
+            return c;
+        }
+    }
+    return -1;
+}
+
+// Parses "column=value", "column<value" or "column>value"; returns false if it is not a valid filter
+static bool parseFilter(const std::string& text, Filter& filter) {
+    size_t at = text.find_first_of("=<>");
+    if (at == std::string::npos || at == 0 || at + 1 >= text.size()) {
+        return false;
+    }
+    filter.column = findColumn(text.substr(0, at));
+    filter.op = text[at];
+    std::string value = text.substr(at + 1);
+    const char* letter = value.size() == 1 ? std::strchr(PIECE_LETTERS, value[0]) : nullptr;
+    if (filter.column == static_cast<int>(PieceStatsColumn::Type) && letter) {
+        filter.value = static_cast<Sint32>(letter - PIECE_LETTERS);
+    } else {
+        filter.value = std::atoi(value.c_str());
+    }
+    return filter.column >= 0;
+}
+
+static bool matches(const Filter& filter, Sint32 value) {
+    switch (filter.op) {
+        case '=': return value == filter.value;
+        case '<': return value < filter.value;
+        default: return value > filter.value;
+    }
+}
+
+// Plays AI games through the simulation tick (so lock times are measured) and records every piece they place
+static int record(const char* path, int games, int piecesPerGame, Uint32 seed) {
+    PieceStatsWriter writer;
+    if (!writer.open(path)) {
+        std::printf("cannot open %s for writing\n", path);
+        return 1;
+    }
+    static const SDL_Keycode keys[] = {SDLK_A, SDLK_D, SDLK_S, SDLK_W};  // InputAction order
+
+    Game game(seed);
+    game.setPieceStats(&writer);
+    Uint64 now = 0;
+    Uint64 pieces = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (int g = 0; g < games; ++g) {
+        if (g > 0) {
+            game.resetGame(seed + static_cast<Uint32>(g));
+        }
+        AIPlayer ai(&game);
+        InputAction action;
+        while (game.getPiecesSpawned() <= piecesPerGame && ai.nextAction(action)) {
+            SDL_Event event;
+            SDL_zero(event);
+            event.type = SDL_EVENT_KEY_DOWN;
+            event.key.key = keys[static_cast<int>(action)];
+            game.processEvent(event);
+            now += 1000 / 60;  // One input per 60 Hz tick
+            game.simulationTick(now);
+        }
+        pieces += game.getPiecesSpawned() - 1;
+    }
+    if (!writer.close()) {
+        std::printf("writing %s failed, the file may be missing pieces\n", path);
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    std::printf("recorded %llu pieces from %d games in %.2f s\n", static_cast<unsigned long long>(pieces), games, seconds);
+    return 0;
+}
+
+// Prints the size of the file and of each column
+static void summary(const PieceStatsFile& file) {
+    Uint64 bytes[PIECE_STATS_COLUMNS] = {0};
+    int runs[PIECE_STATS_COLUMNS] = {0};
+    Sint32 games = 0;
+    for (int i = 0; i < file.blockCount(); ++i) {
+        const PieceStatsBlockHeader& header = file.blockHeader(i);
+        for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+            bytes[c] += header.chunks[c].size;
+            runs[c] += header.chunks[c].encoding == static_cast<Uint8>(PieceStatsEncoding::Runs) ? 1 : 0;
+        }
+        Sint32 lastGame = file.block(i).max[static_cast<int>(PieceStatsColumn::Game)];
+        if (lastGame + 1 > games) games = lastGame + 1;
+    }
+    std::printf("%llu pieces, %d games, %d blocks%s\n", static_cast<unsigned long long>(file.rows()), games,
+                file.blockCount(), file.recovered() ? " (index rebuilt from the blocks)" : "");
+    Uint64 total = 0;
+    for (int c = 0; c < PIECE_STATS_COLUMNS; ++c) {
+        double perRow = file.rows() ? static_cast<double>(bytes[c]) / file.rows() : 0.0;
+        std::printf("  %-12s %10llu bytes  %5.2f bytes/piece  runs in %d of %d blocks\n",
+                    pieceStatsColumnName(static_cast<PieceStatsColumn>(c)), static_cast<unsigned long long>(bytes[c]),
+                    perRow, runs[c], file.blockCount());
+        total += bytes[c];
+    }
+    double raw = static_cast<double>(file.rows()) * sizeof(PieceStatsRecord);
+    std::printf("  column data  %10llu bytes  (%.1fx smaller than %llu-byte records)\n", static_cast<unsigned long long>(total),
+                total ? raw / total : 0.0, static_cast<unsigned long long>(sizeof(PieceStatsRecord)));
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::strcmp(argv[1], "--record") == 0) {
+        int games = argc > 3 ? std::atoi(argv[3]) : 1000;
+        int piecesPerGame = argc > 4 ? std::atoi(argv[4]) : 500;
+        Uint32 seed = argc > 5 ? static_cast<Uint32>(std::atoi(argv[5])) : 1;
+        return record(argv[2], games, piecesPerGame, seed);
+    }
+    if (argc < 2) {
+        std::printf("usage: stats_query <file> [count|sum|avg|min|max [column]] [column=value|column<value|column>value ...]\n"
+                    "       stats_query --record <file> [games] [pieces per game] [seed]\n");
+        return 1;
+    }
+
+    PieceStatsFile file;
+    if (!file.open(argv[1])) {
+        std::printf("%s is not a statistics file\n", argv[1]);
+        return 1;
+    }
+    if (argc == 2) {
+        summary(file);
+        return 0;
+    }
+
+    // Aggregate, its column, then the filters
+    std::string aggregate = argv[2];
+    int arg = 3;
+    int column = -1;
+    if (aggregate != "count") {
+        if (aggregate != "sum" && aggregate != "avg" && aggregate != "min" && aggregate != "max") {
+            std::printf("unknown aggregate: %s\n", aggregate.c_str());
+            return 1;
+        }
+        column = argc > arg ? findColumn(argv[arg++]) : -1;
+        if (column < 0) {
+            std::printf("%s needs a column\n", aggregate.c_str());
+            return 1;
+        }
+    }
+    std::vector<Filter> filters;
+    for (; arg < argc; ++arg) {
+        Filter filter;
+        if (!parseFilter(argv[arg], filter)) {
+            std::printf("invalid filter: %s\n", argv[arg]);
+            return 1;
+        }
+        filters.push_back(filter);
+    }
+
+    Uint32 maxRows = 0;
+    for (int i = 0; i < file.blockCount(); ++i) {
+        if (file.block(i).rows > maxRows) maxRows = file.block(i).rows;
+    }
+    std::vector<Sint32> values(maxRows), filterValues(maxRows);
+    std::vector<Uint8> selected(maxRows);
+
+    auto begin = std::chrono::steady_clock::now();
+    Uint64 count = 0;
+    double sum = 0;
+    Sint32 lowest = 0, highest = 0;
+    int blocksRead = 0;
+    Uint64 rowsRead = 0;
+    for (int i = 0; i < file.blockCount(); ++i) {
+        const PieceStatsIndexEntry& block = file.block(i);
+        int rows = static_cast<int>(block.rows);
+
+        // Skip the block if a filter rules out its whole range, before decoding anything
+        bool skip = false;
+        for (const Filter& filter : filters) {
+            Sint32 min = block.min[filter.column], max = block.max[filter.column];
+            if (filter.op == '=' ? (filter.value < min || filter.value > max) : !matches(filter, filter.op == '<' ? min : max)) {
+                skip = true;
+                break;
+            }
+        }
+        if (skip) {
+            continue;
+        }
+
+        // Decode only the filters the block does not satisfy entirely
+        bool decoded = false;
+        for (const Filter& filter : filters) {
+            Sint32 min = block.min[filter.column], max = block.max[filter.column];
+            if (matches(filter, min) && matches(filter, max) && (filter.op != '=' || min == max)) {
+                continue;
+            }
+            file.decode(i, static_cast<PieceStatsColumn>(filter.column), filterValues.data());
+            if (!decoded) {
+                std::memset(selected.data(), 1, rows);
+                decoded = true;
+            }
+            for (int r = 0; r < rows; ++r) {
+                selected[r] &= matches(filter, filterValues[r]) ? 1 : 0;
+            }
+        }
+        blocksRead++;
+        rowsRead += rows;
+
+        if (column >= 0) {
+            file.decode(i, static_cast<PieceStatsColumn>(column), values.data());
+        }
+        for (int r = 0; r < rows; ++r) {
+            if (decoded && !selected[r]) {
+                continue;
+            }
+            if (column >= 0) {
+                Sint32 value = values[r];
+                if (count == 0 || value < lowest) lowest = value;
+                if (count == 0 || value > highest) highest = value;
+                sum += value;
+            }
+            count++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if (aggregate == "count") {
+        std::printf("count = %llu\n", static_cast<unsigned long long>(count));
+    } else if (count == 0) {
+        std::printf("%s(%s) = (no matching pieces)\n", aggregate.c_str(), argv[3]);
+    } else {
+        double result = aggregate == "sum" ? sum : aggregate == "avg" ? sum / count : aggregate == "min" ? lowest : highest;
+        std::printf("%s(%s) = %.4f over %llu pieces\n", aggregate.c_str(), argv[3], result, static_cast<unsigned long long>(count));
+    }
+    std::printf("%d of %d blocks read (%llu of %llu pieces) in %.3f ms, %.0f million pieces/s\n", blocksRead, file.blockCount(),
+                static_cast<unsigned long long>(rowsRead), static_cast<unsigned long long>(file.rows()), seconds * 1000.0,
+                seconds > 0 ? rowsRead / seconds / 1e6 : 0.0);
+    return 0;
+}
@@ -0,0 +1,224 @@
+// telemetry_reader.cpp
+//
+// Reads the telemetry ring published by "Testris_graphic --telemetry [name]".
+//   telemetry_reader [name]                      prints every tick as it arrives
+//   telemetry_reader [name] --stress N seconds   runs N readers spinning on the ring and reports the
+//                                                writer's tick rate and worst tick gap meanwhile
+//   telemetry_reader [name] --stress N seconds --uncapped
+//                                                publishes into its own block ("<name>_uncapped") as fast as
+//                                                it can instead of following the game's 60 Hz ticks, first
+//                                                with no reader and then with N, and compares the two
+// Readers map the block read-only and never take a lock, so they cannot slow the writer down:
+// the stress mode shows the tick rate and gaps are the same with 0 or 16 spinning readers. At 60 Hz the
+// writer is almost never inside a slot, so the uncapped mode (with a 4-slot ring) is the one that shows seqlock
+// contention: the share of reads retried, and the writer's rate against the run without readers. Run it on a
+// machine with more cores than readers, or the readers only time-slice with the writer.
+//
+// Build: g++ -O2 -std=c++11 -I.. -I<SDL3 include dir> telemetry_reader.cpp ../telemetry.cpp -o telemetry_reader -pthread (add -lrt on older glibc)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "telemetry.h"
+
+// Ring size of the uncapped block: small, so the writer keeps coming back to the slots the readers are copying
+static const Uint32 UNCAPPED_SLOTS = 4;
+
+static const char* actionNames[] = {"left", "right", "down", "rotate", "reset", "hint"};
+
+// Prints one record on a single line
+static void printRecord(const TelemetryRecord& record) {
+    std::printf("tick %llu  score %d  speed %d  lines %d  piece %d at (%d,%d)%s",
+                static_cast<unsigned long long>(record.tick), record.score, record.speed, record.linesCleared,
+                record.pieceType, record.pieceX, record.pieceY, record.gameOver ? "  GAME OVER" : "");
+    for (int i = 0; i < record.inputCount && i < TelemetryRecord::MAX_INPUTS; ++i) {
+        std::printf("%s%s", i == 0 ? "  inputs: " : ",", record.inputs[i] < 6 ? actionNames[record.inputs[i]] : "?");
+    }
+    std::printf("\n");
+}
+
+// Follows the ring and prints every record; reports records lost because this reader fell behind
+static void follow(const TelemetryReader& reader, Uint32 slotCount) {
+    Uint64 next = reader.published();
+    Uint64 lost = 0;
+    for (;;) {
+        Uint64 published = reader.published();
+        if (published - next > slotCount) {
+            lost += published - next - slotCount;
+            next = published - slotCount;  // Oldest record still in the ring
+        }
+        for (; next < published; ++next) {
+            TelemetryRecord record;
+            if (reader.read(next, record)) {
+                printRecord(record);
+            } else {
+                lost++;  // Overwritten while we were copying it
+            }
+        }
+        if (lost) {
+            std::printf("(%llu records lost so far)\n", static_cast<unsigned long long>(lost));
+            lost = 0;
+        }
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+// Runs spinning readers while measuring the writer from the timestamps it publishes
+static void stress(const TelemetryReader& reader, Uint32 slotCount, int readerCount, int seconds) {
+    std::atomic<bool> stop(false);
+    std::atomic<Uint64> reads(0), retries(0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < readerCount; ++i) {
+        threads.push_back(std::thread([&]() {
+            Uint64 ok = 0, failed = 0;
+            TelemetryRecord record;
+            while (!stop) {
+                Uint64 published = reader.published();
+                if (published == 0) continue;
+                if (reader.read(published - 1, record)) ok++; else failed++;
+            }
+            reads += ok;
+            retries += failed;
+        }));
+    }
+
+    // Watch the writer: every record carries the time its tick ran
+    Uint64 next = reader.published();
+    Uint64 ticks = 0, lastTime = 0, maxGap = 0, firstTime = 0;
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        Uint64 published = reader.published();
+        if (published - next > slotCount) next = published - slotCount;
+        for (; next < published; ++next) {
+            TelemetryRecord record;
+            if (!reader.read(next, record)) continue;
+            if (lastTime && record.timeNS - lastTime > maxGap) maxGap = record.timeNS - lastTime;
+            if (!firstTime) firstTime = record.timeNS;
+            lastTime = record.timeNS;
+            ticks++;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    double span = lastTime > firstTime ? (lastTime - firstTime) / 1e9 : 0.0;
+    std::printf("%d spinning readers for %d s\n", readerCount, seconds);
+    std::printf("  writer: %llu ticks, %.1f ticks/s, worst gap between ticks %.2f ms\n",
+                static_cast<unsigned long long>(ticks), span > 0 ? (ticks - 1) / span : 0.0, maxGap / 1e6);
+    std::printf("  readers: %.0f reads/s, %llu reads retried because the slot was being written\n",
+                reads / static_cast<double>(seconds), static_cast<unsigned long long>(retries.load()));
+}
+
+// Runs the spinning readers on a ring fed by a writer with no frame cap, and reports what the writer achieved
+static void stressRun(TelemetryWriter& writer, const TelemetryReader& reader, int readerCount, int seconds) {
+    std::atomic<bool> stop(false);
+    std::atomic<Uint64> reads(0), retries(0);
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < readerCount; ++i) {
+        threads.push_back(std::thread([&]() {
+            Uint64 ok = 0, failed = 0;
+            TelemetryRecord record;
+            while (!stop) {
+                Uint64 published = reader.published();
+                if (published == 0) continue;
+                if (reader.read(published - 1, record)) ok++; else failed++;
+            }
+            reads += ok;
+            retries += failed;
+        }));
+    }
+
+    // Publish back to back, timing each call; the clock is only read every 1024 records
+    TelemetryRecord record = TelemetryRecord();
+    Uint64 published = 0, worstNS = 0;
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    auto last = start;
+    for (;;) {
+        for (int i = 0; i < 1024; ++i) {
+            record.tick = published++;
+            writer.publish(record);
+        }
+        auto now = std::chrono::steady_clock::now();
+        Uint64 batchNS = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count();
+        if (batchNS > worstNS) worstNS = batchNS;
+        last = now;
+        if (now >= end) break;
+    }
+    double span = std::chrono::duration<double>(last - start).count();
+
+    stop = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::printf("%2d spinning readers: writer %.1f M records/s, worst 1024-record batch %.1f us (%.0f ns per record)",
+                readerCount, published / span / 1e6, worstNS / 1e3, worstNS / 1024.0);
+    if (readerCount) {
+        std::printf(", readers %.1f M reads/s with %.2f%% retried", reads / span / 1e6,
+                    reads + retries ? 100.0 * retries / (reads + retries) : 0.0);
+    }
+    std::printf("\n");
+}
+
+// Uncapped stress: the same spinning readers, but on a ring this tool writes into itself without any frame cap
+static int stressUncapped(const std::string& name, int readerCount, int seconds) {
+    TelemetryWriter writer;
+    TelemetryReader reader;
+    if (!writer.open(name + "_uncapped", UNCAPPED_SLOTS) || !reader.open(name + "_uncapped")) {
+        std::fprintf(stderr, "could not create telemetry '%s_uncapped'\n", name.c_str());
+        return 1;
+    }
+    std::printf("uncapped writer, %d s per run\n", seconds);
+    stressRun(writer, reader, 0, seconds);
+    stressRun(writer, reader, readerCount, seconds);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    std::string name = argc > 1 && argv[1][0] != '-' ? argv[1] : "tetris_telemetry";
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--uncapped") {
+            for (int j = 1; j < argc; ++j) {
+                if (std::string(argv[j]) == "--stress") {
+                    int readers = j + 1 < argc && argv[j + 1][0] != '-' ? std::atoi(argv[j + 1]) : 4;
+                    int seconds = j + 2 < argc && argv[j + 2][0] != '-' ? std::atoi(argv[j + 2]) : 5;
+                    return stressUncapped(name, readers, seconds);
+                }
+            }
+            return stressUncapped(name, 4, 5);
+        }
+    }
+
+    TelemetryReader reader;
+    while (!reader.open(name)) {
+        std::fprintf(stderr, "waiting for telemetry '%s'...\n", name.c_str());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+    }
+    Uint32 slotCount = reader.slotCount();
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--stress") {
+            int readers = i + 1 < argc ? std::atoi(argv[i + 1]) : 4;
+            int seconds = i + 2 < argc ? std::atoi(argv[i + 2]) : 5;
+            stress(reader, slotCount, readers, seconds);
+            return 0;
+        }
+    }
+
+    follow(reader, slotCount);
+    return 0;
+}
@@ -0,0 +1,186 @@
+/* tetris_env_check.c
+
+   Plain C driver for the tetris_env library: checks that the C interface behaves
+   (ABI version, deterministic resets, step_many matching step, error codes) and measures steps per second.
+   Exits with 1 if any check fails.
+
+   Build the library from tetris_env.cpp and every game .cpp except main.cpp, for example with MinGW:
+     g++ -O2 -shared -o tetris_env.dll tetris_env.cpp game.cpp board.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+     gcc -O2 -o tetris_env_check.exe tools/tetris_env_check.c tetris_env.dll
+   Usage: tetris_env_check [environments] [seconds] */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../tetris_env.h"
+
+static int failures = 0;
+
+/* Reports a failed check */
+static void check(int condition, const char* what) {
+    if (!condition) {
+        printf("FAILED: %s\n", what);
+        failures++;
+    }
+}
+
+/* Small deterministic generator for the actions */
+static uint32_t nextRandom(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+/* Sanity checks on a single observation */
+static int observationIsValid(const TetrisObservation* obs) {
+    int x, y, i;
+    for (y = 0; y < TETRIS_ENV_HEIGHT; ++y) {
+        for (x = 0; x < TETRIS_ENV_WIDTH; ++x) {
+            if (obs->grid[y][x] > 1) return 0;
+        }
+    }
+    if (obs->piece_type > 6) return 0;
+    for (i = 0; i < TETRIS_ENV_QUEUE; ++i) {
+        if (obs->queue[i] > 6) return 0;
+    }
+    if (!obs->game_over) {
+        for (i = 0; i < 4; ++i) {
+            x = obs->piece_blocks[i][0];
+            y = obs->piece_blocks[i][1];
+            if (x < 0 || x >= TETRIS_ENV_WIDTH || y < 0 || y >= TETRIS_ENV_HEIGHT) return 0;
+        }
+    }
+    return obs->reserved == 0;
+}
+
+/* Two environments reset with the same seed and fed the same actions must stay identical:
+   first when both are stepped one by one, then when environment 0 is stepped with tetris_env_step
+   and environment 1 with tetris_env_step_many */
+static void checkDeterminism(void) {
+    TetrisEnv* env = tetris_env_create(2);
+    TetrisObservation a, b;
+    int32_t rewardA, rewardB;
+    uint8_t doneA, doneB, action;
+    uint32_t rng = 12345;
+    int pass, step, valid = 1, same[2] = {1, 1};
+
+    tetris_env_reset(env, 0, 42, &a);
+    tetris_env_reset(env, 1, 42, &b);
+    check(memcmp(&a, &b, sizeof(a)) == 0, "same seed gives the same first observation");
+
+    for (pass = 0; pass < 2; ++pass) {
+        tetris_env_reset(env, 0, 42 + pass, &a);
+        tetris_env_reset(env, 1, 42 + pass, &b);
+        for (step = 0; step < 20000; ++step) {
+            action = (uint8_t)(nextRandom(&rng) % TETRIS_ACTION_COUNT);
+            tetris_env_step(env, 0, action, &a, &rewardA, &doneA);
+            if (pass == 0) {
+                tetris_env_step(env, 1, action, &b, &rewardB, &doneB);
+            } else {
+                tetris_env_step_many(env, 1, 1, &action, &b, &rewardB, &doneB);
+            }
+            same[pass] = same[pass] && memcmp(&a, &b, sizeof(a)) == 0 && rewardA == rewardB && doneA == doneB;
+            valid = valid && observationIsValid(&a);
+            if (doneA || doneB) {
+                tetris_env_reset(env, 0, (uint32_t)step, &a);
+                tetris_env_reset(env, 1, (uint32_t)step, &b);
+            }
+        }
+    }
+    check(same[0], "identical actions keep identical observations");
+    check(same[1], "step_many matches step (observations, rewards and done flags at every step)");
+    check(valid, "observations stay within the documented ranges");
+    tetris_env_destroy(env);
+}
+
+/* Out-of-range indices and actions are refused with an error code and leave the environments untouched */
+static void checkErrors(void) {
+    TetrisEnv* env = tetris_env_create(2);
+    TetrisObservation before, after;
+    uint8_t actions[3] = {TETRIS_ACTION_LEFT, TETRIS_ACTION_COUNT, TETRIS_ACTION_NONE};
+    int32_t reward = 0;
+
+    tetris_env_reset(env, 0, 7, &before);
+    check(tetris_env_step(NULL, 0, TETRIS_ACTION_NONE, NULL, NULL, NULL) == TETRIS_ENV_ERROR_NULL, "step refuses a NULL set");
+    check(tetris_env_step(env, 2, TETRIS_ACTION_NONE, NULL, NULL, NULL) == TETRIS_ENV_ERROR_INDEX, "step refuses index == count");
+    check(tetris_env_step(env, -1, TETRIS_ACTION_NONE, NULL, NULL, NULL) == TETRIS_ENV_ERROR_INDEX, "step refuses a negative index");
+    check(tetris_env_step(env, 0, TETRIS_ACTION_COUNT, NULL, &reward, NULL) == TETRIS_ENV_ERROR_ACTION, "step refuses an unknown action");
+    check(tetris_env_step(env, 0, -1, NULL, NULL, NULL) == TETRIS_ENV_ERROR_ACTION, "step refuses a negative action");
+    check(tetris_env_reset(env, 5, 1, NULL) == TETRIS_ENV_ERROR_INDEX, "reset refuses an out-of-range index");
+    check(tetris_env_step_many(env, 1, 2, actions, NULL, NULL, NULL) == TETRIS_ENV_ERROR_INDEX, "step_many refuses a range past the end");
+    check(tetris_env_step_many(env, 0, -1, actions, NULL, NULL, NULL) == TETRIS_ENV_ERROR_INDEX, "step_many refuses a negative count");
+    check(tetris_env_step_many(env, 0, 2, NULL, NULL, NULL, NULL) == TETRIS_ENV_ERROR_NULL, "step_many refuses NULL actions");
+    check(tetris_env_step_many(env, 0, 2, actions, NULL, NULL, NULL) == TETRIS_ENV_ERROR_ACTION, "step_many refuses an unknown action");
+    check(tetris_env_step_many(env, 0, 0, actions, NULL, NULL, NULL) == TETRIS_ENV_OK, "step_many accepts an empty range");
+
+    /* Environment 0 was not stepped by any refused call (the refused step_many had a valid first action) */
+    tetris_env_step(env, 0, TETRIS_ACTION_NONE, &after, NULL, NULL);
+    tetris_env_reset(env, 1, 7, NULL);
+    tetris_env_step(env, 1, TETRIS_ACTION_NONE, &before, NULL, NULL);
+    check(memcmp(&before, &after, sizeof(before)) == 0, "refused calls leave the environments untouched");
+    tetris_env_destroy(env);
+}
+
+/* Steps many environments with random actions for a while and reports steps per second */
+static void measureThroughput(int count, double seconds) {
+    TetrisEnv* env = tetris_env_create(count);
+    TetrisObservation* obs = (TetrisObservation*)malloc(sizeof(TetrisObservation) * count);
+    int32_t* rewards = (int32_t*)malloc(sizeof(int32_t) * count);
+    uint8_t* dones = (uint8_t*)malloc(count);
+    uint8_t* actions = (uint8_t*)malloc(count);
+    uint32_t rng = 7;
+    long long steps = 0, resets = 0;
+    clock_t start = clock(), end;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        tetris_env_reset(env, i, (uint32_t)i + 1, &obs[i]);
+    }
+
+    do {
+        int round;
+        for (round = 0; round < 100; ++round) {
+            for (i = 0; i < count; ++i) {
+                actions[i] = (uint8_t)(nextRandom(&rng) % TETRIS_ACTION_COUNT);
+            }
+            tetris_env_step_many(env, 0, count, actions, obs, rewards, dones);
+            for (i = 0; i < count; ++i) {
+                if (dones[i]) {
+                    tetris_env_reset(env, i, nextRandom(&rng), &obs[i]);
+                    resets++;
+                }
+            }
+            steps += count;
+        }
+        end = clock();
+    } while ((double)(end - start) / CLOCKS_PER_SEC < seconds);
+
+    printf("%d environments: %lld steps (%lld resets) in %.2f s = %.0f steps/s on one thread\n",
+           count, steps, resets, (double)(end - start) / CLOCKS_PER_SEC,
+           steps / ((double)(end - start) / CLOCKS_PER_SEC));
+
+    free(actions);
+    free(dones);
+    free(rewards);
+    free(obs);
+    tetris_env_destroy(env);
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 256;
+    double seconds = argc > 2 ? atof(argv[2]) : 2.0;
+
+    check(tetris_env_abi_version() == TETRIS_ENV_ABI_VERSION, "library and header ABI versions match");
+    check(sizeof(TetrisObservation) == 232, "TetrisObservation is 232 bytes");
+    check(tetris_env_create(0) == NULL, "creating zero environments fails");
+
+    checkDeterminism();
+    checkErrors();
+    if (count > 0) {
+        measureThroughput(count, seconds);
+    }
+
+    printf(failures ? "%d check(s) failed\n" : "all checks passed\n", failures);
+    return failures ? 1 : 0;
+}
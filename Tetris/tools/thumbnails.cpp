@@ -0,0 +1,229 @@
+// thumbnails.cpp
+//
+// Draws board thumbnails without a window: plays seeded games with the AI player, takes a snapshot of each
+// board partway through, then rasterizes every snapshot on several threads and reports thumbnails per second.
+// When an output directory is given, the first thumbnails are also written there as PAM images (RGBA).
+//   thumbnails [threads] [boards] [cell size] [rounds] [output dir]
+//   thumbnails --verify [boards]   compares every pixel with a naive per-pixel reference for cell sizes 1 to 30,
+//                                  and the span fill with a plain loop for every length and alignment;
+//                                  exits with 1 on the first mismatch
+//
+// Build: compile together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -pthread -I. tools/thumbnails.cpp board_rasterizer.cpp ai_player.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "game.h"
+#include "ai_player.h"
+#include "board_rasterizer.h"
+
+static const int IMAGES_WRITTEN = 16;  // Thumbnails saved when an output directory is given
+static const int VERIFY_MAX_CELL = 30;  // Largest cell size checked by --verify
+static const int VERIFY_PADDING = 12;   // Bytes after each row that --verify checks the rasterizer leaves alone
+static const Uint8 VERIFY_FILL = 0x55;  // Value of the untouched bytes
+
+// Plays a seeded game with the AI player for a number of inputs and keeps a snapshot of where it stands
+static void playBoard(Uint32 seed, int inputs, FrameSnapshot& frame) {
+    Game game(seed);
+    AIPlayer ai(&game);
+    for (int i = 0; i < inputs && !game.isGameOver(); ++i) {
+        InputAction action;
+        if (!ai.nextAction(action)) {
+            break;
+        }
+        game.applyInput(action);
+        if (i % 3 == 0) {
+            game.update();  // Gravity every few inputs, so pieces also fall on their own
+        }
+    }
+    game.fillSnapshot(frame);
+}
+
+// Writes one thumbnail as a PAM image; returns false if the file cannot be written
+static bool writePam(const char* path, const Uint8* pixels, int width, int height) {
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n", width, height);
+    bool written = std::fwrite(pixels, 4, static_cast<size_t>(width) * height, file) == static_cast<size_t>(width) * height;
+    return std::fclose(file) == 0 && written;
+}
+
+// Reference rasterizer: every pixel of every cell decided on its own, the way Board::drawCell and
+// Piece::drawBlock draw them (fill first, then the one-pixel border, no border below 4 pixels per cell)
+static void drawReference(const FrameSnapshot& frame, int cellSize, std::vector<Uint8>& image) {
+    int width = frame.width * cellSize;
+    image.assign(static_cast<size_t>(width) * frame.height * cellSize * 4, 0);
+    auto put = [&](int x, int y, SDL_Color color) {
+        Uint8* pixel = &image[(static_cast<size_t>(y) * width + x) * 4];
+        pixel[0] = color.r;
+        pixel[1] = color.g;
+        pixel[2] = color.b;
+        pixel[3] = 255;
+    };
+    auto cell = [&](int cx, int cy, bool filled, SDL_Color fill, SDL_Color border) {
+        for (int y = cy * cellSize; y < (cy + 1) * cellSize; ++y) {
+            for (int x = cx * cellSize; x < (cx + 1) * cellSize; ++x) {
+                bool edge = x == cx * cellSize || x == (cx + 1) * cellSize - 1 || y == cy * cellSize || y == (cy + 1) * cellSize - 1;
+                if (edge && cellSize >= 4) {
+                    put(x, y, border);
+                } else if (filled) {
+                    put(x, y, fill);
+                } else {
+                    put(x, y, {0, 0, 0, 255});
+                }
+            }
+        }
+    };
+    for (int cy = 0; cy < frame.height; ++cy) {
+        for (int cx = 0; cx < frame.width; ++cx) {
+            SDL_Color color = frame.cells[cy * frame.width + cx];
+            cell(cx, cy, color.r || color.g || color.b, color, {200, 200, 200, 255});
+        }
+    }
+    if (!frame.gameOver) {
+        for (const auto& block : frame.pieceBlocks) {
+            if (block.first >= 0 && block.first < frame.width && block.second >= 0 && block.second < frame.height) {
+                cell(block.first, block.second, true, frame.pieceColor, {0, 0, 0, 255});
+            }
+        }
+    }
+}
+
+// Checks fillSpan against a plain loop for every length up to 70 and every start alignment, including that it
+// writes nothing outside the span
+static bool verifySpans() {
+    const Uint32 value = 0x11223344, guard = 0xdeadbeef;
+    std::vector<Uint32> pixels(80);
+    for (int offset = 0; offset < 4; ++offset) {
+        for (int count = 0; count <= 70; ++count) {
+            std::fill(pixels.begin(), pixels.end(), guard);
+            BoardRasterizer::fillSpan(pixels.data() + offset, count, value);
+            for (int i = 0; i < static_cast<int>(pixels.size()); ++i) {
+                bool inside = i >= offset && i < offset + count;
+                if (pixels[i] != (inside ? value : guard)) {
+                    std::printf("MISMATCH: fillSpan of %d pixels at offset %d, pixel %d\n", count, offset, i);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Draws every board at every cell size into a padded buffer and compares it with the reference
+static int verify(const std::vector<FrameSnapshot>& frames) {
+    if (!verifySpans()) {
+        return 1;
+    }
+    std::vector<Uint8> pixels, expected;
+    for (int cellSize = 1; cellSize <= VERIFY_MAX_CELL; ++cellSize) {
+        BoardRasterizer rasterizer(cellSize);
+        for (int i = 0; i < static_cast<int>(frames.size()); ++i) {
+            const FrameSnapshot& frame = frames[i];
+            int rowBytes = rasterizer.imageWidth(frame.width) * 4;
+            int pitch = rowBytes + VERIFY_PADDING;
+            int height = rasterizer.imageHeight(frame.height);
+            pixels.assign(static_cast<size_t>(pitch) * height, VERIFY_FILL);
+            rasterizer.draw(frame, pixels.data(), pitch);
+            drawReference(frame, cellSize, expected);
+            for (int y = 0; y < height; ++y) {
+                const Uint8* row = &pixels[static_cast<size_t>(y) * pitch];
+                bool padded = true;
+                for (int b = rowBytes; b < pitch; ++b) {
+                    padded = padded && row[b] == VERIFY_FILL;
+                }
+                if (std::memcmp(row, &expected[static_cast<size_t>(y) * rowBytes], rowBytes) != 0 || !padded) {
+                    std::printf("MISMATCH: board %d, cell size %d, scanline %d%s\n", i, cellSize, y,
+                                padded ? "" : " (wrote past the row)");
+                    return 1;
+                }
+            }
+        }
+    }
+    std::printf("fillSpan and %d boards at cell sizes 1 to %d match the reference\n", static_cast<int>(frames.size()), VERIFY_MAX_CELL);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::strcmp(argv[1], "--verify") == 0) {
+        int boards = argc > 2 ? std::atoi(argv[2]) : 64;
+        std::vector<FrameSnapshot> frames(boards < 1 ? 1 : boards);
+        for (int i = 0; i < static_cast<int>(frames.size()); ++i) {
+            playBoard(static_cast<Uint32>(i + 1), 50 + (i * 37) % 1500, frames[i]);
+        }
+        return verify(frames);
+    }
+
+    int threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    int boards = argc > 2 ? std::atoi(argv[2]) : 256;
+    int cellSize = argc > 3 ? std::atoi(argv[3]) : 8;
+    int rounds = argc > 4 ? std::atoi(argv[4]) : 50;
+    const char* outputDir = argc > 5 ? argv[5] : nullptr;
+    if (threads < 1) {
+        threads = 1;
+    }
+    if (boards < 1 || cellSize < 1 || rounds < 1) {
+        std::printf("usage: thumbnails [threads] [boards] [cell size] [rounds] [output dir]\n");
+        return 1;
+    }
+
+    // Boards at different stages: the number of inputs played grows with the seed
+    std::vector<FrameSnapshot> frames(boards);
+    for (int i = 0; i < boards; ++i) {
+        playBoard(static_cast<Uint32>(i + 1), 50 + (i * 37) % 1500, frames[i]);
+    }
+
+    BoardRasterizer sizes(cellSize);
+    int width = sizes.imageWidth(frames[0].width);
+    int height = sizes.imageHeight(frames[0].height);
+    int pitch = width * 4;
+
+    // Each thread draws its share of the boards, 'rounds' times over, into its own buffer
+    std::vector<std::vector<Uint8>> images(threads, std::vector<Uint8>(static_cast<size_t>(pitch) * height));
+    std::vector<std::thread> workers;
+    auto begin = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            BoardRasterizer rasterizer(cellSize);
+            Uint8* pixels = images[t].data();
+            for (int round = 0; round < rounds; ++round) {
+                for (int i = t; i < boards; i += threads) {
+                    rasterizer.draw(frames[i], pixels, pitch);
+                }
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    double thumbnails = static_cast<double>(boards) * rounds;
+    std::printf("%d threads, %d boards, %dx%d pixels (cell %d), %d rounds\n", threads, boards, width, height, cellSize, rounds);
+    std::printf("%.0f thumbnails in %.3f s: %.0f thumbnails/s, %.1f MB/s\n", thumbnails, seconds,
+                thumbnails / seconds, thumbnails * pitch * height / seconds / 1e6);
+
+    if (outputDir) {
+        BoardRasterizer rasterizer(cellSize);
+        std::vector<Uint8> pixels(static_cast<size_t>(pitch) * height);
+        for (int i = 0; i < boards && i < IMAGES_WRITTEN; ++i) {
+            char path[1024];
+            std::snprintf(path, sizeof(path), "%s/board_%03d.pam", outputDir, i);
+            rasterizer.draw(frames[i], pixels.data(), pitch);
+            if (!writePam(path, pixels.data(), width, height)) {
+                std::printf("cannot write %s\n", path);
+                return 1;
+            }
+        }
+        std::printf("wrote %d thumbnails to %s\n", boards < IMAGES_WRITTEN ? boards : IMAGES_WRITTEN, outputDir);
+    }
+    return 0;
+}
@@ -0,0 +1,203 @@
+// versus_loopback.cpp
+//
+// Plays a versus match between two AI-driven peers over UDP on 127.0.0.1, each on its own thread and at 60 frames
+// per second, through a simulated network (latency, jitter and packet loss on every packet). Checks that both peers
+// confirm the same frames with the same checksums, and reports rollback depth and re-simulation cost per frame.
+// With --desync, peer 1 changes its copy of player 0's game at frame 120 and the run must report a desync.
+// A third socket sends stray packets to peer 0 throughout; they must all be rejected as not coming from the peer.
+// Exits with 1 if the peers desynced (or, with --desync, if they did not), confirmed too few frames or took a stray packet.
+//   versus_loopback [frames] [latency ms] [jitter ms] [loss %] [input delay] [--desync]
+//
+// Build: compile together with every game .cpp except main.cpp, for example
+//   g++ -O2 -std=c++11 -pthread -I. tools/versus_loopback.cpp versus.cpp udp_link.cpp ai_player.cpp board.cpp game.cpp piece.cpp audio_manager.cpp telemetry.cpp frame_capture.cpp perfect_clear.cpp alloc_tracker.cpp piece_stats.cpp -lSDL3 -lSDL3_mixer -lSDL3_ttf
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "versus.h"
+#include "ai_player.h"
+
+static const int BASE_PORT = 47800;      // Peer p listens on BASE_PORT + p
+static const int AI_ACTION_FRAMES = 4;   // Frames between two AI actions
+static const int DESYNC_FRAME = 120;     // Frame changed by --desync
+static const int STRAY_FRAMES = 30;      // Frames between two stray packets sent to peer 0
+static const Uint64 LINGER_NS = 2 * SDL_NS_PER_SECOND;  // Time a peer keeps answering after its last frame
+
+// Everything one peer ends with
+struct PeerResult {
+    bool connected = false;
+    Uint32 frames = 0;
+    Uint32 confirmed = 0;
+    VersusStats stats;
+    Uint64 sent = 0, dropped = 0, received = 0, rejected = 0;
+    Uint64 straySent = 0;            // Stray packets sent to this peer
+    int pieces[2] = {0, 0}, scores[2] = {0, 0};   // Both games as this peer simulated them
+    std::vector<Uint32> checksums;   // Checksum of every confirmed frame still kept at the end
+    Uint32 firstChecksum = 0;        // Frame of checksums[0]
+};
+
+// Runs one peer: an AI plays the local game, one input every few frames, at 60 frames per second
+static void runPeer(int player, int frames, const NetworkConditions& conditions, int delay, bool desync, PeerResult& result) {
+    VersusSession* session = new VersusSession(player, 12345, delay);
+    result.connected = session->connect(BASE_PORT + player, "127.0.0.1", BASE_PORT + 1 - player, conditions);
+    if (!result.connected) {
+        delete session;
+        return;
+    }
+    if (desync && player == 1) {
+        session->injectDesync(DESYNC_FRAME);
+    }
+    AIPlayer ai(session->getGame(player));
+
+    // Peer 0 also gets packets from an unrelated port, which look like its peer's except for the sender
+    UdpLink stray;
+    if (player == 0 && !stray.open(BASE_PORT + 2, "127.0.0.1", BASE_PORT, NetworkConditions())) {
+        std::printf("could not open the stray UDP port %d\n", BASE_PORT + 2);
+    }
+    Uint8 strayPacket[64];
+    std::memset(strayPacket, 0xA5, sizeof(strayPacket));
+
+    const Uint64 frameNS = SDL_NS_PER_SECOND / VersusSession::FRAME_RATE;
+    Uint64 nextFrame = SDL_GetTicksNS();
+    VersusInput pending = 0;
+    while (static_cast<int>(session->getFrame()) < frames && !session->isOver()) {
+        session->poll();
+
+        // The AI looks at the local game as currently simulated; its input is kept until a frame takes it
+        if (pending == 0 && session->getFrame() % AI_ACTION_FRAMES == 0) {
+            InputAction action;
+            if (ai.nextAction(action)) {
+                pending = static_cast<VersusInput>(1 + static_cast<int>(action));
+            }
+        }
+        if (session->advance(pending)) {
+            pending = 0;
+        }
+        if (player == 0 && session->getFrame() % STRAY_FRAMES == 0) {
+            stray.send(strayPacket, sizeof(strayPacket));
+            stray.flush();
+            result.straySent++;
+        }
+
+        nextFrame += frameNS;
+        Uint64 now = SDL_GetTicksNS();
+        if (nextFrame > now) {
+            SDL_DelayPrecise(nextFrame - now);
+        } else {
+            nextFrame = now;
+        }
+    }
+
+    // Keep exchanging packets for a while so both sides confirm the last frames
+    Uint64 lingerEnd = SDL_GetTicksNS() + LINGER_NS;
+    while (SDL_GetTicksNS() < lingerEnd) {
+        session->poll();
+        session->keepAlive();
+        SDL_DelayPrecise(frameNS);
+    }
+
+    result.frames = session->getFrame();
+    result.confirmed = session->getConfirmedFrame();
+    result.stats = session->getStats();
+    result.sent = session->getLink().getSent();
+    result.dropped = session->getLink().getDropped();
+    result.received = session->getLink().getReceived();
+    result.rejected = session->getLink().getRejected();
+    for (int p = 0; p < 2; ++p) {
+        result.pieces[p] = session->getGame(p)->getPiecesSpawned();
+        result.scores[p] = session->getGame(p)->getScore();
+    }
+    result.firstChecksum = result.confirmed > VersusSession::HISTORY ? result.confirmed - VersusSession::HISTORY : 0;
+    for (Uint32 f = result.firstChecksum; f < result.confirmed; ++f) {
+        Uint32 checksum = 0;
+        session->getChecksum(f, checksum);
+        result.checksums.push_back(checksum);
+    }
+    delete session;
+}
+
+static void report(int player, const PeerResult& result) {
+    const VersusStats& s = result.stats;
+    std::printf("peer %d: %u frames, %u confirmed, %llu stalls\n", player, result.frames, result.confirmed,
+                static_cast<unsigned long long>(s.stalls));
+    std::printf("  games: player 0 %d pieces, score %d; player 1 %d pieces, score %d\n", result.pieces[0], result.scores[0],
+                result.pieces[1], result.scores[1]);
+    std::printf("  rollbacks: %llu (%.1f%% of frames), depth avg %.2f max %d frames\n", static_cast<unsigned long long>(s.rollbacks),
+                s.frames ? 100.0 * s.rollbacks / s.frames : 0.0, s.rollbacks ? static_cast<double>(s.rollbackFrames) / s.rollbacks : 0.0,
+                s.maxRollback);
+    std::printf("  re-simulation: %.2f us per frame, %.2f us per re-simulated frame, longest rollback %.1f us\n",
+                s.frames ? s.resimulationNS / 1000.0 / s.frames : 0.0, s.rollbackFrames ? s.resimulationNS / 1000.0 / s.rollbackFrames : 0.0,
+                s.maxResimulationNS / 1000.0);
+    std::printf("  packets: %llu sent, %llu dropped by the simulated network, %llu received, %llu of %llu stray packets rejected\n",
+                static_cast<unsigned long long>(result.sent), static_cast<unsigned long long>(result.dropped),
+                static_cast<unsigned long long>(result.received), static_cast<unsigned long long>(result.rejected),
+                static_cast<unsigned long long>(result.straySent));
+    std::printf("  checksums compared with the peer: %llu, desync: %s\n", static_cast<unsigned long long>(s.checksumsCompared),
+                s.desyncFrame < 0 ? "none" : "yes");
+}
+
+int main(int argc, char* argv[]) {
+    bool desync = false;
+    std::vector<int> values;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--desync") == 0) {
+            desync = true;
+        } else {
+            values.push_back(std::atoi(argv[i]));
+        }
+    }
+    int frames = values.size() > 0 ? values[0] : 900;
+    NetworkConditions conditions;
+    conditions.latencyMs = values.size() > 1 ? values[1] : 50;
+    conditions.jitterMs = values.size() > 2 ? values[2] : 10;
+    conditions.lossPercent = values.size() > 3 ? values[3] : 5;
+    int delay = values.size() > 4 ? values[4] : 2;
+
+    std::printf("%d frames, latency %d ms + up to %d ms jitter, %d%% loss, input delay %d frames%s\n", frames, conditions.latencyMs,
+                conditions.jitterMs, conditions.lossPercent, delay, desync ? ", desync injected" : "");
+
+    SDL_Init(0);
+    PeerResult results[2];
+    std::thread peers[2];
+    for (int p = 0; p < 2; ++p) {
+        peers[p] = std::thread(runPeer, p, frames, conditions, delay, desync, std::ref(results[p]));
+    }
+    for (int p = 0; p < 2; ++p) {
+        peers[p].join();
+    }
+    if (!results[0].connected || !results[1].connected) {
+        std::printf("could not open the UDP ports %d and %d\n", BASE_PORT, BASE_PORT + 1);
+        return 1;
+    }
+    report(0, results[0]);
+    report(1, results[1]);
+
+    // Compare the confirmed checksums both peers still hold
+    Uint32 from = results[0].firstChecksum > results[1].firstChecksum ? results[0].firstChecksum : results[1].firstChecksum;
+    Uint32 to = results[0].confirmed < results[1].confirmed ? results[0].confirmed : results[1].confirmed;
+    int mismatches = 0;
+    for (Uint32 f = from; f < to; ++f) {
+        if (results[0].checksums[f - results[0].firstChecksum] != results[1].checksums[f - results[1].firstChecksum]) {
+            mismatches++;
+        }
+    }
+    std::printf("final check: frames %u to %u, %d checksum mismatches\n", from, to, mismatches);
+
+    bool desynced = mismatches > 0 || results[0].stats.desyncFrame >= 0 || results[1].stats.desyncFrame >= 0;
+    bool strayRejected = results[0].rejected == results[0].straySent && results[1].rejected == 0;
+    bool complete = to + VersusSession::MAX_ROLLBACK >= results[0].frames && to + VersusSession::MAX_ROLLBACK >= results[1].frames;
+    SDL_Quit();
+    if (desync) {
+        std::printf(desynced ? "desync detected as expected\n" : "FAILED: the injected desync was not detected\n");
+        return desynced ? 0 : 1;
+    }
+    if (desynced || !complete || !strayRejected) {
+        std::printf("FAILED: %s\n", desynced ? "the peers desynced" : !complete ? "too few frames were confirmed" : "stray packets were not rejected");
+        return 1;
+    }
+    std::printf("peers stayed in sync\n");
+    return 0;
+}
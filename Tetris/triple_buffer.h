@@ -0,0 +1,52 @@
+// triple_buffer.h
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>   // Include atomic for the lock-free slot exchange
+
+// Lock-free single-producer / single-consumer triple buffer.
+// The producer always owns one slot to write into, the consumer always owns one slot to read from,
+// and the third slot is exchanged between them. Neither side ever waits for the other:
+// the producer overwrites stale frames, the consumer simply keeps its last frame if nothing new arrived.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), writeIndex(0), readIndex(2) {}
+
+    // Producer side: the slot to fill before calling publish()
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    // Producer side: hands the written slot to the consumer and takes back the shared one
+    void publish() {
+        int old = middle.exchange(writeIndex | FRESH);
+        writeIndex = old & INDEX_MASK;
+    }
+
+    // Consumer side: takes the most recently published slot if there is one; returns true if it did
+    bool fetch() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) {
+            return false;  // Nothing new since the last fetch
+        }
+        int old = middle.exchange(readIndex);
+        readIndex = old & INDEX_MASK;
+        return true;
+    }
+
+    // Consumer side: the last fetched slot
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+    // Either side: checks if a published slot is waiting to be fetched
+    bool hasNew() const { return (middle.load() & FRESH) != 0; }
+
+private:
+    static const int INDEX_MASK = 3;  // Low bits hold the index of the shared slot
+    static const int FRESH = 4;       // Set when the shared slot holds an unread frame
+
+    T buffers[3];               // The three slots
+    std::atomic<int> middle;    // Index of the shared slot, plus the FRESH flag
+    int writeIndex;             // Slot owned by the producer
+    int readIndex;              // Slot owned by the consumer
+};
+
+#endif
@@ -0,0 +1,183 @@
+// udp_link.cpp
+
+#include <cstring>      // Include for memcpy
+
+#include "udp_link.h"   // Includes the UdpLink class
+
+#ifdef _WIN32
+#include <winsock2.h>   // Include for the Winsock sockets and inet_addr (link with ws2_32)
+typedef int socklen_t;
+#else
+#include <sys/socket.h> // Include for socket / sendto / recvfrom
+#include <netinet/in.h> // Include for sockaddr_in
+#include <arpa/inet.h>  // Include for inet_pton / htons
+#include <fcntl.h>      // Include for the non-blocking flag
+#include <unistd.h>     // Include for close
+#endif
+
+static_assert(sizeof(sockaddr_in) <= 32, "UdpLink::peer is too small for a sockaddr_in");
+
+UdpLink::UdpLink() : rng(1), sent(0), dropped(0), received(0), rejected(0), isOpen(false), sock(0) {
+    std::memset(peer, 0, sizeof(peer));
+}
+
+UdpLink::~UdpLink() {
+    close();
+}
+
+bool UdpLink::open(int localPort, const char* remoteHost, int remotePort, const NetworkConditions& conditions, Uint32 seed) {
+    close();
+    network = conditions;
+    rng = seed ? seed : 1;
+    held.assign(MAX_HELD, HeldPacket());
+    for (HeldPacket& packet : held) {
+        packet.size = 0;
+    }
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<Uint16>(remotePort));
+#ifdef _WIN32
+    // inet_pton needs Vista headers (_WIN32_WINNT 0x0600), which older MinGW toolchains do not target by default
+    address.sin_addr.s_addr = inet_addr(remoteHost);
+    if (address.sin_addr.s_addr == INADDR_NONE) {
+        return false;
+    }
+#else
+    if (inet_pton(AF_INET, remoteHost, &address.sin_addr) != 1) {
+        return false;
+    }
+#endif
+    std::memcpy(peer, &address, sizeof(address));
+
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) {
+        return false;
+    }
+    SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == INVALID_SOCKET) {
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+    sock = static_cast<Uint64>(s);
+#else
+    int s = socket(AF_INET, SOCK_DGRAM, 0);
+    if (s < 0) {
+        return false;
+    }
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+    sock = s;
+#endif
+    isOpen = true;
+
+    sockaddr_in local;
+    std::memset(&local, 0, sizeof(local));
+    local.sin_family = AF_INET;
+    local.sin_port = htons(static_cast<Uint16>(localPort));
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    if (bind(s, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpLink::close() {
+    if (!isOpen) {
+        return;
+    }
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(sock));
+    WSACleanup();
+#else
+    ::close(sock);
+#endif
+    isOpen = false;
+}
+
+Uint32 UdpLink::nextRandom() {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+void UdpLink::send(const void* data, int size) {
+    if (!isOpen || size <= 0 || size > MAX_PACKET) {
+        return;
+    }
+    if (network.lossPercent > 0 && static_cast<int>(nextRandom() % 100) < network.lossPercent) {
+        dropped++;
+        return;
+    }
+    if (network.latencyMs <= 0 && network.jitterMs <= 0) {
+        sendNow(data, size);
+        return;
+    }
+
+    // Hold the packet back until its delivery time; if the network is full, the packet is lost
+    Uint64 delayMs = static_cast<Uint64>(network.latencyMs) + (network.jitterMs > 0 ? nextRandom() % (network.jitterMs + 1) : 0);
+    for (HeldPacket& packet : held) {
+        if (packet.size == 0) {
+            packet.dueNS = SDL_GetTicksNS() + delayMs * SDL_NS_PER_MS;
+            packet.size = size;
+            std::memcpy(packet.data, data, size);
+            return;
+        }
+    }
+    dropped++;
+}
+
+void UdpLink::flush() {
+    if (!isOpen) {
+        return;
+    }
+    Uint64 now = SDL_GetTicksNS();
+    for (HeldPacket& packet : held) {
+        if (packet.size > 0 && packet.dueNS <= now) {
+            sendNow(packet.data, packet.size);
+            packet.size = 0;
+        }
+    }
+}
+
+void UdpLink::sendNow(const void* data, int size) {
+#ifdef _WIN32
+    sendto(static_cast<SOCKET>(sock), static_cast<const char*>(data), size, 0, reinterpret_cast<const sockaddr*>(peer), sizeof(sockaddr_in));
+#else
+    sendto(sock, data, static_cast<size_t>(size), 0, reinterpret_cast<const sockaddr*>(peer), sizeof(sockaddr_in));
+#endif
+    sent++;
+}
+
+int UdpLink::receive(void* data, int capacity) {
+    if (!isOpen) {
+        return 0;
+    }
+    sockaddr_in expected;
+    std::memcpy(&expected, peer, sizeof(expected));
+    for (;;) {
+        sockaddr_in from;
+        socklen_t fromSize = sizeof(from);
+#ifdef _WIN32
+        int size = recvfrom(static_cast<SOCKET>(sock), static_cast<char*>(data), capacity, 0, reinterpret_cast<sockaddr*>(&from), &fromSize);
+#else
+        int size = static_cast<int>(recvfrom(sock, data, static_cast<size_t>(capacity), 0, reinterpret_cast<sockaddr*>(&from), &fromSize));
+#endif
+        if (size <= 0) {
+            return 0;  // Nothing waiting (or an error, treated the same way: the peer's next packet repeats everything)
+        }
+        // Anyone can send to the port: only the peer's packets are given to the session
+        if (fromSize < static_cast<socklen_t>(sizeof(from)) || from.sin_family != AF_INET ||
+            from.sin_addr.s_addr != expected.sin_addr.s_addr || from.sin_port != expected.sin_port) {
+            rejected++;
+            continue;
+        }
+        received++;
+        return size;
+    }
+}
@@ -0,0 +1,76 @@
+// udp_link.h
+
+#ifndef UDP_LINK_H
+#define UDP_LINK_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the fixed-size integer types and the clock
+#include <vector>       // Include vector for the packets held back by the simulated network
+
+// Network conditions simulated on outgoing packets, so a link over loopback behaves like a real connection
+struct NetworkConditions {
+    int latencyMs = 0;     // One-way delay added to every packet
+    int jitterMs = 0;      // Random extra delay, 0 to jitterMs (packets can arrive out of order)
+    int lossPercent = 0;   // Chance that a packet is dropped
+};
+
+// A non-blocking UDP socket talking to one peer. Packets go through the simulated network first:
+// dropped ones are counted, the others are held back until their delivery time and sent by flush()
+class UdpLink {
+public:
+    static const int MAX_PACKET = 512;    // Largest packet sent or received
+    static const int MAX_HELD = 256;      // Packets the simulated network can hold back at once
+
+    UdpLink();
+    ~UdpLink();
+
+    // Binds to localPort and sends to remoteHost:remotePort (an IPv4 address); returns false on failure
+    bool open(int localPort, const char* remoteHost, int remotePort, const NetworkConditions& conditions, Uint32 seed = 1);
+
+    // Closes the socket
+    void close();
+
+    // Queues a packet through the simulated network
+    void send(const void* data, int size);
+
+    // Sends the held-back packets that are due
+    void flush();
+
+    // Receives one packet from the peer if there is one; returns its size, or 0 if nothing is waiting.
+    // Packets from any other address or port are read and discarded
+    int receive(void* data, int capacity);
+
+    // Counters for reports
+    Uint64 getSent() const { return sent; }
+    Uint64 getDropped() const { return dropped; }
+    Uint64 getReceived() const { return received; }
+    Uint64 getRejected() const { return rejected; }
+
+private:
+    // A packet waiting for its delivery time
+    struct HeldPacket {
+        Uint64 dueNS;               // SDL_GetTicksNS() at which it is sent
+        int size;                   // Size of the packet, 0 for a free slot
+        Uint8 data[MAX_PACKET];
+    };
+
+    // Sends a packet right away
+    void sendNow(const void* data, int size);
+
+    // Next number of the link's own generator (xorshift), for loss and jitter
+    Uint32 nextRandom();
+
+    NetworkConditions network;       // Conditions applied to outgoing packets
+    std::vector<HeldPacket> held;    // MAX_HELD slots
+    Uint32 rng;                      // Generator state
+    Uint64 sent, dropped, received;  // Packet counters
+    Uint64 rejected;                 // Packets discarded because they did not come from the peer
+    bool isOpen;                     // True once open() succeeded
+#ifdef _WIN32
+    Uint64 sock;                     // SOCKET handle
+#else
+    int sock;                        // Socket descriptor
+#endif
+    Uint8 peer[32];                  // Address of the peer (a sockaddr_in)
+};
+
+#endif
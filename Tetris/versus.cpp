@@ -0,0 +1,253 @@
+// versus.cpp
+
+#include <cstddef>       // Include for offsetof
+#include <cstring>       // Include for memset
+
+#include "versus.h"      // Includes the VersusSession class
+
+// Checksum of both games, from their own checksums
+static Uint32 combine(Uint32 first, Uint32 second) {
+    return first ^ (second * 0x9e3779b1u + 0x7f4a7c15u + (first << 6) + (first >> 2));
+}
+
+VersusSession::VersusSession(int localPlayer, Uint32 seed, int inputDelay) {
+    local = localPlayer == 1 ? 1 : 0;
+    remote = 1 - local;
+    delay = inputDelay < 0 ? 0 : (inputDelay > MAX_DELAY ? MAX_DELAY : inputDelay);
+
+    // Both peers build the same two games: same seeds, no audio, nothing that depends on the machine
+    games[0] = new Game(seed);
+    games[1] = new Game(seed * 2654435761u + 1);
+
+    std::memset(inputs, 0, sizeof(inputs));
+    inputEnd[local] = static_cast<Uint32>(delay);  // The first 'delay' frames have no local input
+    inputEnd[remote] = 0;
+    frame = 0;
+    confirmed = 0;
+    for (int i = 0; i < HISTORY; ++i) {
+        checksums[i] = 0;
+        checksumFrames[i] = VersusPacket::NO_CHECKSUM;
+    }
+    peerAck = 0;
+    peerChecksumFrame = VersusPacket::NO_CHECKSUM;
+    peerChecksum = 0;
+    comparedFrame = VersusPacket::NO_CHECKSUM;
+    over = false;
+    desyncAt = VersusPacket::NO_CHECKSUM;
+
+    // Fill every saved state once, so rollbacks only copy into storage that already exists
+    for (int i = 0; i < HISTORY; ++i) {
+        games[0]->saveState(states[i][0]);
+        games[1]->saveState(states[i][1]);
+    }
+    games[0]->saveState(current[0]);
+    games[1]->saveState(current[1]);
+}
+
+VersusSession::~VersusSession() {
+    delete games[0];
+    delete games[1];
+}
+
+bool VersusSession::connect(int localPort, const char* remoteHost, int remotePort, const NetworkConditions& conditions) {
+    return link.open(localPort, remoteHost, remotePort, conditions, static_cast<Uint32>(localPort) * 2654435761u + 1);
+}
+
+VersusInput VersusSession::inputOf(int player, Uint32 f) const {
+    return f < inputEnd[player] ? inputs[player][f % HISTORY] : 0;
+}
+
+void VersusSession::simulateFrame(Uint32 f) {
+    Uint64 now = static_cast<Uint64>(f + 1) * 1000 / FRAME_RATE;  // Frame time, the same on both peers
+    for (int p = 0; p < 2; ++p) {
+        Game* game = games[p];
+        if (game->isGameOver()) {
+            continue;
+        }
+        VersusInput input = inputOf(p, f);
+        if (input >= 1 && input <= 1 + static_cast<int>(InputAction::Rotate)) {
+            game->applyInput(static_cast<InputAction>(input - 1));
+        }
+        game->applyGravity(now);
+    }
+
+    // Testing only: a change the peer does not make (applied again whenever this frame is simulated again)
+    if (f == desyncAt) {
+        games[remote]->receiveGarbage(1);
+    }
+
+    // Garbage reaches the opponent in the same frame, so both peers see it arrive at the same time
+    int sent0 = games[0]->takeGarbageSent();
+    int sent1 = games[1]->takeGarbageSent();
+    games[1]->receiveGarbage(sent0);
+    games[0]->receiveGarbage(sent1);
+}
+
+void VersusSession::rollback(Uint32 from) {
+    Uint64 start = SDL_GetTicksNS();
+    int depth = static_cast<int>(frame - from);
+
+    games[0]->loadState(states[from % HISTORY][0]);
+    games[1]->loadState(states[from % HISTORY][1]);
+    for (Uint32 f = from; f < frame; ++f) {
+        if (f > from) {
+            games[0]->saveState(states[f % HISTORY][0]);
+            games[1]->saveState(states[f % HISTORY][1]);
+        }
+        simulateFrame(f);
+    }
+
+    Uint64 elapsed = SDL_GetTicksNS() - start;
+    stats.rollbacks++;
+    stats.rollbackFrames += depth;
+    if (depth > stats.maxRollback) stats.maxRollback = depth;
+    stats.resimulationNS += elapsed;
+    if (elapsed > stats.maxResimulationNS) stats.maxResimulationNS = elapsed;
+}
+
+void VersusSession::poll() {
+    link.flush();
+    VersusPacket packet;
+    int size;
+    while ((size = link.receive(&packet, sizeof(packet))) > 0) {
+        if (size >= static_cast<int>(offsetof(VersusPacket, inputs)) && packet.magic == VersusPacket::MAGIC &&
+            packet.player == remote && packet.count <= VersusPacket::MAX_INPUTS &&
+            size >= static_cast<int>(offsetof(VersusPacket, inputs)) + packet.count) {
+            receive(packet);
+        }
+    }
+    confirm();
+}
+
+void VersusSession::receive(const VersusPacket& packet) {
+    if (packet.ack > peerAck && packet.ack <= inputEnd[local]) {
+        peerAck = packet.ack;
+    }
+    compareChecksum();  // Before it is replaced by a newer one
+    if (packet.checksumFrame != VersusPacket::NO_CHECKSUM &&
+        (peerChecksumFrame == VersusPacket::NO_CHECKSUM || packet.checksumFrame > peerChecksumFrame) &&
+        (comparedFrame == VersusPacket::NO_CHECKSUM || packet.checksumFrame > comparedFrame)) {
+        peerChecksumFrame = packet.checksumFrame;
+        peerChecksum = packet.checksum;
+    }
+
+    // Take the inputs that follow the ones already known (packets can come late, twice or out of order).
+    // Inputs too far ahead are left for a later packet, so the ring never overwrites frames still needed
+    Uint32 end = packet.firstFrame + packet.count;
+    Uint32 limit = frame + HISTORY - MAX_ROLLBACK;
+    if (end > limit) end = limit;
+    if (packet.firstFrame > inputEnd[remote] || end <= inputEnd[remote]) {
+        return;
+    }
+    Uint32 mispredicted = end;
+    for (Uint32 f = inputEnd[remote]; f < end; ++f) {
+        VersusInput input = packet.inputs[f - packet.firstFrame];
+        inputs[remote][f % HISTORY] = input;
+        if (input != 0 && f < frame && mispredicted == end) {
+            mispredicted = f;  // This frame was simulated with no input for the peer
+        }
+    }
+    inputEnd[remote] = end;
+    if (mispredicted < end) {
+        rollback(mispredicted);
+    }
+}
+
+void VersusSession::confirm() {
+    Uint32 known = inputEnd[remote] < inputEnd[local] ? inputEnd[remote] : inputEnd[local];
+    Uint32 target = known < frame ? known : frame;
+    for (; confirmed < target; ++confirmed) {
+        // The state after frame 'confirmed' is the one saved at the start of the next frame, or the current one
+        Uint32 next = confirmed + 1;
+        const GameState* after = states[next % HISTORY];
+        if (next == frame) {
+            games[0]->saveState(current[0]);
+            games[1]->saveState(current[1]);
+            after = current;
+        }
+        checksums[confirmed % HISTORY] = combine(after[0].checksum(), after[1].checksum());
+        checksumFrames[confirmed % HISTORY] = confirmed;
+        if (after[0].gameOver || after[1].gameOver) {
+            over = true;
+        }
+    }
+    compareChecksum();
+}
+
+void VersusSession::compareChecksum() {
+    if (peerChecksumFrame == VersusPacket::NO_CHECKSUM || peerChecksumFrame >= confirmed) {
+        return;
+    }
+    Uint32 ours;
+    if (getChecksum(peerChecksumFrame, ours)) {
+        stats.checksumsCompared++;
+        comparedFrame = peerChecksumFrame;
+        if (ours != peerChecksum && stats.desyncFrame < 0) {
+            stats.desyncFrame = peerChecksumFrame;
+            SDL_Log("Versus: desync at frame %u (checksum %08x, peer %08x)", peerChecksumFrame, ours, peerChecksum);
+        }
+    }
+    peerChecksumFrame = VersusPacket::NO_CHECKSUM;  // Each checksum is compared once
+}
+
+bool VersusSession::getChecksum(Uint32 confirmedFrame, Uint32& checksum) const {
+    if (confirmedFrame >= confirmed || checksumFrames[confirmedFrame % HISTORY] != confirmedFrame) {
+        return false;
+    }
+    checksum = checksums[confirmedFrame % HISTORY];
+    return true;
+}
+
+bool VersusSession::advance(VersusInput localInput) {
+    // Too far ahead of the peer, or of what it acknowledged: wait, but keep it informed
+    if (frame >= inputEnd[remote] + MAX_ROLLBACK || inputEnd[local] >= peerAck + VersusPacket::MAX_INPUTS) {
+        stats.stalls++;
+        send();
+        return false;
+    }
+
+    // The local input applies 'delay' frames from now
+    inputs[local][inputEnd[local] % HISTORY] = localInput;
+    inputEnd[local]++;
+
+    games[0]->saveState(states[frame % HISTORY][0]);
+    games[1]->saveState(states[frame % HISTORY][1]);
+    simulateFrame(frame);
+    frame++;
+    stats.frames++;
+
+    confirm();
+    send();
+    return true;
+}
+
+void VersusSession::keepAlive() {
+    send();
+    link.flush();
+}
+
+void VersusSession::send() {
+    VersusPacket packet;
+    packet.magic = VersusPacket::MAGIC;
+    packet.firstFrame = peerAck;
+    packet.ack = inputEnd[remote];
+    packet.checksumFrame = VersusPacket::NO_CHECKSUM;
+    packet.checksum = 0;
+    if (confirmed > 0) {
+        packet.checksumFrame = confirmed - 1;
+        packet.checksum = checksums[(confirmed - 1) % HISTORY];
+    }
+    packet.player = static_cast<Uint8>(local);
+    Uint32 count = inputEnd[local] - peerAck;
+    packet.count = static_cast<Uint8>(count < VersusPacket::MAX_INPUTS ? count : VersusPacket::MAX_INPUTS);
+    packet.reserved = 0;
+    for (int i = 0; i < packet.count; ++i) {
+        packet.inputs[i] = inputs[local][(peerAck + i) % HISTORY];
+    }
+    link.send(&packet, static_cast<int>(offsetof(VersusPacket, inputs)) + packet.count);
+    link.flush();
+}
+
+void VersusSession::injectDesync(Uint32 atFrame) {
+    desyncAt = atFrame;
+}
@@ -0,0 +1,139 @@
+// versus.h
+
+#ifndef VERSUS_H
+#define VERSUS_H
+
+#include <SDL3/SDL.h>     // Include SDL library for the fixed-size integer types and the clock
+
+#include "game.h"         // Includes the Game class and the InputAction enum
+#include "game_state.h"   // Includes the GameState structure used for rollback
+#include "udp_link.h"     // Includes the UdpLink class the inputs travel through
+
+// Input of one player for one frame: 0 for none, otherwise 1 + the InputAction (MoveLeft to Rotate)
+typedef Uint8 VersusInput;
+
+// What a session measured
+struct VersusStats {
+    Uint64 frames = 0;              // Frames simulated for the first time
+    Uint64 stalls = 0;              // Calls to advance() that had to wait for the peer
+    Uint64 rollbacks = 0;           // Times a peer input differed from its prediction
+    Uint64 rollbackFrames = 0;      // Frames rewound, over every rollback
+    int maxRollback = 0;            // Deepest rollback (frames)
+    Uint64 resimulationNS = 0;      // Time spent loading states and simulating frames again
+    Uint64 maxResimulationNS = 0;   // Longest single rollback
+    Uint64 checksumsCompared = 0;   // Confirmed frames whose checksum was compared with the peer's
+    Sint64 desyncFrame = -1;        // First frame whose checksum differed from the peer's, -1 if none
+};
+
+// Packet exchanged every frame: the sender's inputs the receiver has not acknowledged yet, what the
+// sender has received, and the checksum of the sender's last confirmed frame
+struct VersusPacket {
+    static const Uint32 MAGIC = 0x53565254;  // "TRVS"
+    static const int MAX_INPUTS = 64;        // Inputs a packet can carry
+    static const Uint32 NO_CHECKSUM = 0xffffffffu;
+
+    Uint32 magic;            // MAGIC
+    Uint32 firstFrame;       // Frame of inputs[0]
+    Uint32 ack;              // The sender has the receiver's inputs for every frame before this one
+    Uint32 checksumFrame;    // Frame the checksum is for (NO_CHECKSUM if none yet)
+    Uint32 checksum;         // Checksum of both games after that frame
+    Uint8 player;            // Player number of the sender
+    Uint8 count;             // Number of inputs
+    Uint16 reserved;
+    VersusInput inputs[MAX_INPUTS];
+};
+
+// VersusSession runs a two-player game in deterministic lockstep with rollback. Both peers simulate both
+// games from the same seed and only exchange inputs. The peer's inputs that have not arrived yet are predicted
+// (no input); when they arrive and differ, the games are put back to the state saved at that frame and the
+// frames since then are simulated again. Local inputs can be delayed a few frames, which makes rollbacks rarer
+// and shallower. Once both players' inputs of a frame are known the frame is confirmed, and its checksum is
+// compared with the peer's to detect desyncs
+class VersusSession {
+public:
+    static const int HISTORY = 128;         // Frames of inputs, states and checksums kept (a power of two)
+    static const int MAX_ROLLBACK = 20;     // Frames the simulation may run ahead of the peer's inputs
+    static const int MAX_DELAY = 8;         // Largest input delay (frames)
+    static const int FRAME_RATE = 60;       // Simulated frames per second (gravity runs on frame time)
+
+    // Creates both games; 'localPlayer' (0 or 1) is the one this peer controls
+    VersusSession(int localPlayer, Uint32 seed, int inputDelay = 2);
+    ~VersusSession();
+
+    // Opens the UDP link to the peer; returns false on failure
+    bool connect(int localPort, const char* remoteHost, int remotePort, const NetworkConditions& conditions = NetworkConditions());
+
+    // Receives the peer's packets, rolling back if its inputs differ from what was predicted
+    void poll();
+
+    // Advances one frame with the local player's input, then sends the inputs the peer has not acknowledged.
+    // Returns false, without advancing, while the simulation is too far ahead of the peer's inputs
+    bool advance(VersusInput localInput);
+
+    // Sends a packet without advancing (keeps the peer confirming frames after this side stopped)
+    void keepAlive();
+
+    // The two games, as of the last simulated frame (the peer's latest inputs may still be predicted)
+    Game* getGame(int player) const { return games[player]; }
+    int getLocalPlayer() const { return local; }
+
+    // Next frame to simulate, and number of frames simulated with every input known
+    Uint32 getFrame() const { return frame; }
+    Uint32 getConfirmedFrame() const { return confirmed; }
+
+    // Checksum of both games after a confirmed frame (false if it is no longer kept)
+    bool getChecksum(Uint32 confirmedFrame, Uint32& checksum) const;
+
+    // True once a game is over in a confirmed frame
+    bool isOver() const { return over; }
+
+    const VersusStats& getStats() const { return stats; }
+    const UdpLink& getLink() const { return link; }
+
+    // Testing only: from the given frame on, this peer's copy of the other player's game gets a garbage line
+    // the peer never sends, so the checksums of the two peers stop matching
+    void injectDesync(Uint32 atFrame);
+
+private:
+    // Applies the inputs of one frame to both games, then hands the garbage each one sent to the other
+    void simulateFrame(Uint32 f);
+
+    // Input of a player for a frame: the real one if known, otherwise the prediction (none)
+    VersusInput inputOf(int player, Uint32 f) const;
+
+    // Puts both games back to the start of frame 'from' and simulates up to the current frame again
+    void rollback(Uint32 from);
+
+    // Handles one packet from the peer
+    void receive(const VersusPacket& packet);
+
+    // Marks the frames whose inputs are all known as confirmed and records their checksums
+    void confirm();
+
+    // Compares the peer's checksum with ours once we have confirmed that frame too
+    void compareChecksum();
+
+    // Sends the unacknowledged local inputs
+    void send();
+
+    int local, remote;                            // Player numbers of this peer and of the other one
+    int delay;                                    // Local input delay (frames)
+    Game* games[2];                               // Both games, simulated on both peers
+    GameState states[HISTORY][2];                 // State of both games at the start of each kept frame
+    GameState current[2];                         // Scratch copy of the current state (checksums)
+    VersusInput inputs[2][HISTORY];               // Inputs of each player by frame
+    Uint32 inputEnd[2];                           // Inputs are known for every frame before this one
+    Uint32 frame;                                 // Next frame to simulate
+    Uint32 confirmed;                             // Frames simulated with every input known
+    Uint32 checksums[HISTORY];                    // Checksum after each kept confirmed frame
+    Uint32 checksumFrames[HISTORY];               // Frame each entry of checksums is for
+    Uint32 peerAck;                               // The peer has our inputs for every frame before this one
+    Uint32 peerChecksumFrame, peerChecksum;       // Latest checksum received from the peer
+    Uint32 comparedFrame;                         // Last frame whose checksum was compared (NO_CHECKSUM for none)
+    bool over;                                    // A game is over in a confirmed frame
+    Uint32 desyncAt;                              // Frame injectDesync() changes (NO_CHECKSUM for none)
+    UdpLink link;                                 // Connection to the peer
+    VersusStats stats;                            // Counters for reports
+};
+
+#endif
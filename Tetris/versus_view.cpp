@@ -0,0 +1,108 @@
+// versus_view.cpp
+
+#include "versus_view.h"   // Includes the VersusView class
+#include "board.h"         // Includes the Board class which represents the game grid
+#include "piece.h"         // Includes the Piece class which represents the Tetris pieces
+#include "spsc_queue.h"    // Includes the bounded queue holding the key presses
+
+// Constructor: the window holds the two boards next to each other
+VersusView::VersusView(int localPlayer, Uint32 seed, int inputDelay) : session(localPlayer, seed, inputDelay) {
+    Board* board = session.getGame(0)->getBoard();
+    win_Width = 2 * board->getWidth() * Board::CELL_SIZE + GAP;
+    win_Height = board->getHeight() * Board::CELL_SIZE;
+}
+
+bool VersusView::start(int localPort, const char* remoteHost, int remotePort) {
+    if (!session.connect(localPort, remoteHost, remotePort)) {
+        return false;
+    }
+
+    SDL_Init(SDL_INIT_VIDEO);  // Initialize SDL video subsystem
+
+    SDL_Window* window = SDL_CreateWindow("Tetris - Versus", win_Width, win_Height, 0);
+    SDL_Renderer* renderer = SDL_CreateRenderer(window, NULL);
+    SDL_SetRenderVSync(renderer, 1);  // Pace presentation to the display refresh rate
+
+    const Uint64 frameNS = SDL_NS_PER_SECOND / VersusSession::FRAME_RATE;
+    Uint64 nextFrame = SDL_GetTicksNS();
+    Uint64 titleTime = nextFrame;
+    SpscQueue<VersusInput, MAX_QUEUED_KEYS + 1> keys;  // Key presses not yet given to a frame, oldest first
+    VersusInput pending = 0;  // Oldest key press, kept while the session waits for the peer
+    char title[160];
+    bool run = true;
+
+    while (run) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {  // Poll all events
+            if (event.type == SDL_EVENT_QUIT) {
+                run = false;
+            } else if (event.type == SDL_EVENT_KEY_DOWN) {
+                // Presses beyond MAX_QUEUED_KEYS are dropped rather than played long after the key was hit
+                switch (event.key.key) {
+                    case SDLK_ESCAPE: run = false; break;  // Escape key to quit
+                    case SDLK_A: keys.push(1 + static_cast<int>(InputAction::MoveLeft)); break;   // 'A' key to move piece left
+                    case SDLK_D: keys.push(1 + static_cast<int>(InputAction::MoveRight)); break;  // 'D' key to move piece right
+                    case SDLK_S: keys.push(1 + static_cast<int>(InputAction::MoveDown)); break;   // 'S' key to move piece down
+                    case SDLK_W: keys.push(1 + static_cast<int>(InputAction::Rotate)); break;     // 'W' key to rotate piece
+                }
+            }
+        }
+
+        // Run every frame that is due, each taking the oldest queued key press, rolling back first if the
+        // peer's inputs arrived
+        session.poll();
+        Uint64 now = SDL_GetTicksNS();
+        while (nextFrame <= now && !session.isOver()) {
+            if (pending == 0) {
+                keys.pop(pending);
+            }
+            if (!session.advance(pending)) {
+                break;  // Waiting for the peer: try again on the next loop
+            }
+            pending = 0;
+            nextFrame += frameNS;
+        }
+        if (nextFrame + 4 * frameNS < now) {
+            nextFrame = now;  // Do not try to catch up on a long stall
+        }
+        if (session.isOver()) {
+            session.keepAlive();  // Let the peer confirm the last frames too
+        }
+
+        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+        SDL_RenderClear(renderer);
+        int boardWidth = session.getGame(0)->getBoard()->getWidth() * Board::CELL_SIZE;
+        drawGame(renderer, session.getGame(0), 0);
+        drawGame(renderer, session.getGame(1), boardWidth + GAP);
+        SDL_SetRenderViewport(renderer, NULL);
+        SDL_RenderPresent(renderer);
+
+        // Show the scores and the rollback figures in the window title once per second
+        if (now - titleTime >= SDL_NS_PER_SECOND) {
+            const VersusStats& stats = session.getStats();
+            const char* state = stats.desyncFrame >= 0 ? " - DESYNC" : (session.isOver() ? " - game over" : "");
+            SDL_snprintf(title, sizeof(title), "Tetris - Versus - you are player %d - %d : %d - %llu rollbacks (max %d frames, %.1f us resimulation per frame)%s",
+                         session.getLocalPlayer() + 1, session.getGame(0)->getScore(), session.getGame(1)->getScore(),
+                         static_cast<unsigned long long>(stats.rollbacks), stats.maxRollback,
+                         stats.frames ? stats.resimulationNS / 1000.0 / stats.frames : 0.0, state);
+            SDL_SetWindowTitle(window, title);
+            titleTime = now;
+        }
+    }
+
+    // Clean up SDL resources
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return true;
+}
+
+void VersusView::drawGame(SDL_Renderer* renderer, Game* game, int originX) {
+    Board* board = game->getBoard();
+    SDL_Rect viewport = {originX, 0, board->getWidth() * Board::CELL_SIZE, board->getHeight() * Board::CELL_SIZE};
+    SDL_SetRenderViewport(renderer, &viewport);  // The board and piece draw themselves from (0, 0)
+    board->draw(renderer);
+    if (!game->isGameOver()) {
+        game->getPiece()->draw(renderer);
+    }
+}
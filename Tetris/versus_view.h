@@ -0,0 +1,34 @@
+// versus_view.h
+
+#ifndef VERSUS_VIEW_H
+#define VERSUS_VIEW_H
+
+#include <SDL3/SDL.h>   // Include SDL library for the window and renderer
+
+#include "versus.h"     // Includes the VersusSession class
+
+// VersusView plays a two-player game against a peer over UDP. The keyboard drives the local player's game,
+// both boards are shown side by side, and the session advances at its fixed frame rate whatever the display does.
+// Each frame carries at most one input, so key presses wait in a short queue and are given to frames in order
+class VersusView {
+public:
+    // Constructor: 'localPlayer' (0 or 1) must differ on the two peers, 'seed' must be the same
+    VersusView(int localPlayer, Uint32 seed, int inputDelay = 2);
+
+    // Connects to the peer, opens the window and runs the game until it is closed; returns false if the
+    // UDP port could not be opened
+    bool start(int localPort, const char* remoteHost, int remotePort);
+
+private:
+    // Draws one game with its top-left corner at 'originX'
+    void drawGame(SDL_Renderer* renderer, Game* game, int originX);
+
+    static const int GAP = 60;   // Pixels between the two boards
+    static const int MAX_QUEUED_KEYS = 8;   // Key presses that can wait for a frame
+
+    VersusSession session;       // Lockstep session with the peer
+    int win_Width;               // Window dimensions (two boards and the gap)
+    int win_Height;
+};
+
+#endif